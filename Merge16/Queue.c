@@ -7,27 +7,53 @@
  * Addison Hu
  * addison.hu@yale.edu
  *
- * An implementation of the Queue ADT as a headless, singly-linked, 
- * circular list.  The Queue data type is a pointer to the _last_ 
- * node in the list, or NULL if the queue is empty.
+ * An implementation of the Queue ADT as a ring of chunks, each an
+ * array of QCHUNK string pointers.  The string pointers run from
+ * position first of the head chunk to just before position last of
+ * the tail chunk.  Chunks emptied at the head stay in the ring after
+ * the tail and are filled again, so that after the queue has grown to
+ * its largest, addQ() and removeQ() never call malloc() or free().
  **/
 
 #include <stdlib.h>
 #include "/c/cs223/Hwk4/Queue.h"
 
-/** 
+// Number of string pointers per chunk
+#define QCHUNK 256
+
+/**
+ * Struct: Chunk
+ * ~~~~~~~~~~~~~
+ * This structure represents one chunk of the ring.
+ *
+ * members
+ * ~~~~~~~
+ * - line: character strings stored as data
+ * - *next: pointer to the next chunk in the ring
+ **/
+typedef struct chunk {
+    char* line[QCHUNK];
+    struct chunk* next;
+} Chunk;
+
+/**
  * Struct: node
  * ~~~~~~~~~~~~
- * This structure represents a node in a singly-linked list.
+ * This structure represents a queue; Queue points to it.
  *
  * members
  * ~~~~~~~
- * - line: character string stored as data
- * - *next: pointer to the next node
+ * - *head: chunk holding the head of the queue (NULL before the
+ *   first addQ())
+ * - *tail: chunk holding the tail of the queue
+ * - first: position of the head in *head
+ * - last: position after the tail in *tail
  **/
-typedef struct node {       
-    char* line;
-    struct node* next;
+typedef struct node {
+    Chunk* head;
+    Chunk* tail;
+    int first;
+    int last;
 } Node;
 
 /**
@@ -38,18 +64,26 @@ typedef struct node {
  * input
  * ~~~~~
  * - q: pointer to a queue
- * 
- * returns: true upon successful creation
+ *
+ * returns: true upon successful creation, false if malloc failed
  **/
 int createQ(Queue* q) {
-    *q = NULL; 
+    *q = malloc(sizeof(Node));
+    if (*q == NULL) {
+        return false;
+    }
+    (*q)->head = NULL;
+    (*q)->tail = NULL;
+    (*q)->first = 0;
+    (*q)->last = 0;
     return true;
 }
 
 /**
  * Function: addQ()
  * ~~~~~~~~~~~~~~~~
- * Adds the string pointer s to the tail of Queue *q.  
+ * Adds the string pointer s to the tail of Queue *q.  A chunk is only
+ * allocated when every chunk in the ring is in use.
  *
  * inputs
  * ~~~~~~
@@ -57,34 +91,39 @@ int createQ(Queue* q) {
  * - s: pointer to a character string
  *
  * returns: true if successful, false otherwise
- **/ 
+ **/
 int addQ(Queue* q, char* s) {
-    Node* new;
-    new = malloc(sizeof(Node));
-    if (new != NULL) {
-        // store line in new node
-        new->line = s;
-        // handle case when Queue is empty
-        if (*q == NULL) { 
-            *q = new;
-            new->next = new;
-        // otherwise point old tail to new node, 
-        // and point new node to the head
-        } else {
-            Node* old = *q;
-            Node* head = old->next;
-            *q = new;
-            old->next = new;
-            new->next = head;
+    if (*q == NULL) {
+        return false;
+    }
+    Node* Q = *q;
+    // handle case when no chunk has been allocated yet
+    if (Q->tail == NULL) {
+        Q->tail = malloc(sizeof(Chunk));
+        if (Q->tail == NULL) {
+            return false;
         }
-    // return false in malloc failed
-    } else {
-        return false; 
+        Q->tail->next = Q->tail;
+        Q->head = Q->tail;
+    // move on to the next chunk if the tail is full, reusing an
+    // emptied one if there is one, and linking in a new one otherwise
+    } else if (Q->last == QCHUNK) {
+        if (Q->tail->next == Q->head) {
+            Chunk* new = malloc(sizeof(Chunk));
+            if (new == NULL) {
+                return false;
+            }
+            new->next = Q->head;
+            Q->tail->next = new;
+        }
+        Q->tail = Q->tail->next;
+        Q->last = 0;
     }
+    Q->tail->line[Q->last++] = s;
     return true;
 }
-									    
-/** 
+
+/**
  * Function: isEmptyQ()
  * ~~~~~~~~~~~~~~~~~~~~
  * Checks whether a queue is empty.
@@ -92,11 +131,12 @@ int addQ(Queue* q, char* s) {
  * input
  * ~~~~~
  * - q: pointer to a queue
- * 
+ *
  * returns: true if the queue is empty, false otherwise
  **/
 int isEmptyQ(Queue* q) {
-    if (*q == NULL) {
+    if (*q == NULL || ((*q)->head == (*q)->tail
+            && (*q)->first == (*q)->last)) {
         return true;
     } else {
         return false;
@@ -106,7 +146,7 @@ int isEmptyQ(Queue* q) {
 /**
  * Function: headQ()
  * ~~~~~~~~~~~~~~~~~
- * Copies the string pointer at the head of Queue *q to *s, but 
+ * Copies the string pointer at the head of Queue *q to *s, but
  * does not remove it from *q.
  *
  * inputs
@@ -118,21 +158,19 @@ int isEmptyQ(Queue* q) {
  **/
 int headQ (Queue* q, char** s) {
     // return false if queue is empty
-    if (*q == NULL) {
+    if (isEmptyQ(q)) {
         return false;
     } else {
-        // get the head node via the last node
-        Node* head = (*q)->next;
-        *s = head->line;
+        *s = (*q)->head->line[(*q)->first];
     }
     return true;
 }
 
-/** 
+/**
  * Function: removeQ()
  * ~~~~~~~~~~~~~~~~~~~
- * Removes the string pointer at the head of the queue *q and stores 
- * it in *s.
+ * Removes the string pointer at the head of the queue *q and stores
+ * it in *s.  The chunk it leaves empty stays in the ring.
  *
  * inputs
  * ~~~~~~
@@ -143,27 +181,26 @@ int headQ (Queue* q, char** s) {
  **/
 int removeQ(Queue* q, char** s) {
     // return false if queue is empty
-    if (*q == NULL) {
+    if (isEmptyQ(q)) {
         return false;
     } else {
-        Node* tail = *q;
-        Node* head = tail->next;
+        Node* Q = *q;
         // copy string pointer at head to *s
-        *s = head->line;
-        // point the tail to the node after the head if 
-        // there is one
-        if (head != tail) {
-            tail->next = head->next;
-        // otherwise, queue is empty, so set *q to NULL
-        } else {
-            *q = NULL;
+        *s = Q->head->line[Q->first++];
+        // start the tail chunk over if the queue is now empty
+        if (Q->head == Q->tail && Q->first == Q->last) {
+            Q->first = 0;
+            Q->last = 0;
+        // otherwise move on to the next chunk if the head one is used up
+        } else if (Q->first == QCHUNK) {
+            Q->head = Q->head->next;
+            Q->first = 0;
         }
-        free(head);
     }
     return true;
 }
 
-/** 
+/**
  * Function: destroyQ()
  * ~~~~~~~~~~~~~~~~~~~~
  * Destroys the Queue *q by freeing any storage it uses, and sets *q to NULL.
@@ -171,21 +208,24 @@ int removeQ(Queue* q, char** s) {
  * input
  * ~~~~~
  * - q: pointer to a queue
- * 
+ *
  * returns: true if successful
  **/
 int destroyQ (Queue* q) {
-    // if queue is empty, return true
+    // if queue was never created, return true
     if (*q == NULL) {
         return true;
     } else {
-        Node* cur = (*q)->next;
-        Node* prev;
-        // loop through all the nodes, freeing them
-        while (cur != *q) {
-            prev = cur;
-            cur = cur->next;
-            free(prev);
+        // loop through all the chunks of the ring, freeing them
+        if ((*q)->head != NULL) {
+            Chunk* cur = (*q)->head->next;
+            Chunk* prev;
+            while (cur != (*q)->head) {
+                prev = cur;
+                cur = cur->next;
+                free(prev);
+            }
+            free(cur);
         }
         free(*q);
         // set *q to NULL
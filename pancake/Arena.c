@@ -0,0 +1,101 @@
+/**
+ * Arena.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Implementation of a bump (arena) allocator.
+ *
+ **/
+#include "Arena.h"
+
+// Largest number of bytes requested from malloc() for a chunk that
+// holds more than one block; the first chunk only holds the first
+// block, and every later one is twice the size of the one before, so
+// that an arena only used a little costs little to set up and release
+#define CHUNKSIZE (1 << 20)
+
+/**
+ * Function: createA()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Creates an empty arena.  No memory is allocated until the first call
+ * to allocA().
+ *
+ * input
+ * ~~~~~
+ * arena: pointer to Arena struct
+ *
+ * returns: status
+ **/
+int createA(Arena* arena) {
+    arena->chunk = NULL;
+    arena->total = 0;
+    return true;
+}
+
+/**
+ * Function: allocA()
+ * ~~~~~~~~~~~~~~~~~~
+ * Hands out size bytes, aligned for Words and pointers.  Requests larger
+ * than the next chunk would be get a chunk of their own.
+ *
+ * inputs
+ * ~~~~~~
+ * arena: pointer to Arena struct
+ * size: number of bytes wanted
+ *
+ * returns: pointer to memory, NULL if malloc() failed
+ **/
+void* allocA(Arena* arena, size_t size) {
+    // Round up so that the next block stays aligned
+    size = (size + sizeof(long long) - 1) / sizeof(long long)
+            * sizeof(long long);
+    Chunk* c = arena->chunk;
+    if (c == NULL || c->used + size > c->size) {
+        size_t bytes = (c == NULL) ? size : 2 * c->size;
+        if (bytes > CHUNKSIZE) {
+            bytes = CHUNKSIZE;
+        }
+        if (bytes < size) {
+            bytes = size;
+        }
+        c = malloc(sizeof(Chunk) + bytes);
+        if (c == NULL) {
+            return NULL;
+        }
+        c->next = arena->chunk;
+        c->size = bytes;
+        c->used = 0;
+        arena->chunk = c;
+        arena->total += sizeof(Chunk) + bytes;
+    }
+    void* block = (char*) c->data + c->used;
+    c->used += size;
+    return block;
+}
+
+/**
+ * Function: destroyA()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Frees every block the arena ever handed out.
+ *
+ * input
+ * ~~~~~
+ * arena: pointer to Arena struct
+ *
+ * returns: status
+ **/
+int destroyA(Arena* arena) {
+    Chunk* c = arena->chunk;
+    while (c != NULL) {
+        Chunk* next = c->next;
+        free(c);
+        c = next;
+    }
+    arena->chunk = NULL;
+    arena->total = 0;
+    return true;
+}
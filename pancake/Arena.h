@@ -0,0 +1,63 @@
+/**
+ * Arena.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for a bump (arena) allocator.
+ *
+ **/
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * Struct: Chunk
+ * ~~~~~~~~~~~~~
+ * One block of memory handed out by an Arena.  Chunks are chained so
+ * that the whole arena can be released at once.
+ *
+ * members
+ * ~~~~~~~
+ * struct Chunk* next:  previously filled chunk
+ * size_t size:         number of usable bytes in data
+ * size_t used:         number of bytes already handed out
+ * long long data[]:    the memory itself (aligned for Words and pointers)
+ **/
+typedef struct Chunk {
+    struct Chunk* next;
+    size_t size;
+    size_t used;
+    long long data[];
+} Chunk;
+
+/**
+ * Struct: Arena
+ * ~~~~~~~~~~~~~
+ * A bump allocator.  Allocation is a pointer increment within the
+ * current chunk; individual blocks are never freed, only the arena as
+ * a whole.
+ *
+ * members
+ * ~~~~~~~
+ * Chunk* chunk:    chunk currently being filled (NULL if none yet)
+ * size_t total:    number of bytes obtained from malloc()
+ **/
+typedef struct Arena {
+    Chunk* chunk;
+    size_t total;
+} Arena;
+
+/* See Arena.c for full explanations */
+int createA(Arena* arena);
+
+void* allocA(Arena* arena, size_t size);
+
+int destroyA(Arena* arena);
+
+#endif
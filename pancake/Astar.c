@@ -0,0 +1,412 @@
+/**
+ * Astar.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Informed searches from INITIAL to GOAL guided by a Bound.  A* keeps
+ * every configuration it generates in the Hashtable; IDA* keeps only
+ * the current path, so its memory grows with the depth of the search
+ * rather than with the number of configurations.
+ *
+ **/
+#include <limits.h>
+#include <string.h>
+#include "Astar.h"
+#include "Flip.h"
+
+// Initial number of entries the A* open list has room for
+#define MINOPEN 1024
+
+/**
+ * Struct: Entry
+ * ~~~~~~~~~~~~~
+ * An entry in the A* open list.
+ *
+ * members
+ * ~~~~~~~
+ * int f:       g + lower bound on the flips left
+ * int g:       flips from INITIAL when the entry was made
+ * long node:   configuration (index in s->nodes[0])
+ **/
+typedef struct Entry {
+    int f;
+    int g;
+    long node;
+} Entry;
+
+/**
+ * Struct: Open
+ * ~~~~~~~~~~~~
+ * Binary min-heap of Entries ordered by f, breaking ties in favor of
+ * larger g (deeper entries are closer to GOAL).
+ *
+ * members
+ * ~~~~~~~
+ * Entry* data:     heap array
+ * long count:      number of entries
+ * long size:       number of entries data has room for
+ **/
+typedef struct Open {
+    Entry* data;
+    long count;
+    long size;
+} Open;
+
+/**
+ * Struct: Ida
+ * ~~~~~~~~~~~
+ * State of an IDA* search.
+ *
+ * members
+ * ~~~~~~~
+ * Search* s:           search parameters
+ * Bound* b:            lower bound
+ * Move* moves:         every flip
+ * unsigned char* goal: symbol indices of GOAL
+ * unsigned char* path: configurations on the current path, n each
+ * int* last:           index of the flip that produced each of them
+ * int n:               number of cells
+ * int depth:           depth at which GOAL was reached
+ **/
+typedef struct Ida {
+    Search* s;
+    Bound* b;
+    Move* moves;
+    unsigned char* goal;
+    unsigned char* path;
+    int* last;
+    int n;
+    int depth;
+} Ida;
+
+// Returned by dfs() once GOAL has been reached
+#define FOUND -1
+
+static int before(Entry x, Entry y);
+static int pushO(Open* o, Entry e);
+static Entry popO(Open* o);
+static int dfs(Ida* ida, int g, int bound);
+
+/**
+ * Function: astarSearch()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * A* search from INITIAL.  Since the Bound is consistent, the first
+ * time GOAL leaves the open list it has been reached by a shortest
+ * path.  Entries whose f exceeds s->maxlen are never made, and entries 
+ * already s->maxlen flips from INITIAL are not expanded.
+ *
+ * GOAL is also looked for among the neighbors of every entry expanded.
+ * No path is shorter than the f of the entry leaving the open list, so 
+ * reaching GOAL in that many flips ends the search right away, instead 
+ * of after every other entry with the same f.
+ *
+ * New configurations are appended to s->nodes[0] and added to s->dict;
+ * the move of a node is that of the fewest flips found so far, whose 
+ * number is kept in an array alongside.
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search (INITIAL is node 0 of s->nodes[0], and in 
+ *    s->dict)
+ * b: pointer to Bound for GOAL
+ * goal: packed GOAL
+ * last: where to store the node of GOAL
+ *
+ * returns: 1 if a path was found, 0 if not, -1 if memory ran out
+ **/
+int astarSearch(Search* s, Bound* b, Word* goal, long* last) {
+    Packing* pk = s->pk;
+    Nodes* nd = s->nodes[0];
+    int width = pk->width;
+    Word* batch = malloc(sizeof(Word) * width * (s->nStep + 1));
+    unsigned long* codes = malloc(sizeof(unsigned long) * (s->nStep + 1));
+    unsigned char cells[pk->n];
+    // Fewest flips found so far to each node
+    long size = MINOPEN;
+    int* len = malloc(sizeof(int) * size);
+    Open o;
+    o.count = 0;
+    o.size = MINOPEN;
+    o.data = malloc(sizeof(Entry) * o.size);
+    if (batch == NULL || codes == NULL || len == NULL || o.data == NULL) {
+        free(batch);
+        free(codes);
+        free(len);
+        free(o.data);
+        return -1;
+    }
+
+    int found = 0;
+    Entry e;
+    unpackP(pk, configN(nd, 0), cells);
+    e.g = 0;
+    e.f = estimateB(b, cells);
+    e.node = 0;
+    len[0] = 0;
+    if (e.f <= s->maxlen && !pushO(&o, e)) {
+        found = -1;
+    }
+    while (o.count > 0 && !found) {
+        e = popO(&o);
+        long cur = e.node;
+        // A shorter path to cur was found after this entry was made
+        if (e.g != len[cur]) {
+            continue;
+        }
+        if (sameP(configN(nd, cur), goal, width)) {
+            *last = cur;
+            found = 1;
+            break;
+        }
+        // Its neighbors would be more than s->maxlen flips away
+        if (e.g + 1 > s->maxlen) {
+            continue;
+        }
+        // Nodes do not keep their hashes, so cur is hashed again
+        getBatch(pk, configN(nd, cur), s->width, s->height, batch, s->z, 
+                keyZ(s->z, configN(nd, cur)), codes);
+        for (int i = 0; i < s->nStep && !found; i++) {
+            Word* key = batch + i * width;
+            long next = retrieveHashH(s->dict, key, codes[i]);
+            if (next != MISSING && len[indexN(next)] <= e.g + 1) {
+                continue;
+            }
+            unpackP(pk, key, cells);
+            Entry n;
+            n.g = e.g + 1;
+            n.f = n.g + estimateB(b, cells);
+            if (n.f > s->maxlen) {
+                continue;
+            }
+            if (next == MISSING) {
+                long added = addN(nd, key, i);
+                if (added == size) {
+                    int* more = realloc(len, sizeof(int) * 2 * size);
+                    if (more == NULL) {
+                        found = -1;
+                        break;
+                    }
+                    len = more;
+                    size *= 2;
+                }
+                if (added < 0 || addHashH(s->dict, configN(nd, added), 
+                        codes[i], refN(0, added)) <= 0) {
+                    found = -1;
+                    break;
+                }
+                next = refN(0, added);
+            }
+            n.node = indexN(next);
+            moveN(nd, n.node) = i;
+            len[n.node] = n.g;
+            if (n.g == e.f && sameP(key, goal, width)) {
+                *last = n.node;
+                found = 1;
+                break;
+            }
+            if (!pushO(&o, n)) {
+                found = -1;
+            }
+        }
+    }
+    free(o.data);
+    free(batch);
+    free(codes);
+    free(len);
+    return found;
+}
+
+/**
+ * Function: idastarSearch()
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~
+ * IDA* search from INITIAL: depth-first searches that cut off any
+ * configuration whose g + bound exceeds a threshold, starting from the
+ * bound of INITIAL and raising the threshold to the smallest value that
+ * was cut off, until GOAL is reached or the threshold passes s->maxlen.
+ * Only the current path is kept, and a flip is never immediately
+ * undone (every flip is its own inverse).
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search
+ * b: pointer to Bound for GOAL
+ * initial: symbol indices of INITIAL
+ * goal: symbol indices of GOAL
+ * path: where to store a malloc'd array of the configurations on the 
+ *       path, n symbol indices each (NULL if there is no path)
+ *
+ * returns: number of flips in the path, -1 if there is none
+ **/
+int idastarSearch(Search* s, Bound* b, unsigned char* initial,
+        unsigned char* goal, unsigned char** path) {
+    Ida ida;
+    ida.s = s;
+    ida.b = b;
+    ida.n = s->width * s->height;
+    ida.goal = goal;
+    ida.path = NULL;
+    ida.last = NULL;
+    ida.moves = malloc(sizeof(Move) * (s->nStep + 1));
+    if (ida.moves == NULL) {
+        return -1;
+    }
+    listMoves(s->width, s->height, ida.moves);
+
+    int flips = -1;
+    int bound = estimateB(b, initial);
+    while (bound <= s->maxlen) {
+        // Children of the path are at most one flip past the threshold
+        unsigned char* p = realloc(ida.path, ida.n * (bound + 2));
+        int* last = realloc(ida.last, sizeof(int) * (bound + 2));
+        if (p == NULL || last == NULL) {
+            free(p != NULL ? p : ida.path);
+            free(last != NULL ? last : ida.last);
+            ida.path = NULL;
+            ida.last = NULL;
+            break;
+        }
+        ida.path = p;
+        ida.last = last;
+        memcpy(ida.path, initial, ida.n);
+        ida.last[0] = -1;
+        int next = dfs(&ida, 0, bound);
+        if (next == FOUND) {
+            flips = ida.depth;
+            break;
+        }
+        bound = next;
+    }
+    if (flips < 0) {
+        free(ida.path);
+        ida.path = NULL;
+    }
+    *path = ida.path;
+    free(ida.moves);
+    free(ida.last);
+    return flips;
+}
+
+/**
+ * Function: dfs()
+ * ~~~~~~~~~~~~~~~
+ * One depth-first pass of IDA* below the configuration at depth g of
+ * the current path.  When GOAL is reached, its depth is left in
+ * ida->depth.
+ *
+ * inputs
+ * ~~~~~~
+ * ida: pointer to Ida
+ * g: depth of the configuration to expand
+ * bound: threshold on g + lower bound
+ *
+ * returns: FOUND, or the smallest g + lower bound that was cut off
+ **/
+static int dfs(Ida* ida, int g, int bound) {
+    unsigned char* cur = ida->path + g * ida->n;
+    int f = g + estimateB(ida->b, cur);
+    if (f > bound) {
+        return f;
+    }
+    if (!memcmp(cur, ida->goal, ida->n)) {
+        ida->depth = g;
+        return FOUND;
+    }
+    int least = INT_MAX;
+    Search* s = ida->s;
+    for (int i = 0; i < s->nStep; i++) {
+        if (i == ida->last[g]) {
+            continue;
+        }
+        Move m = ida->moves[i];
+        flipPancake(cur, cur + ida->n, s->width, s->height, m.fw, m.fh, m.v);
+        ida->last[g + 1] = i;
+        int next = dfs(ida, g + 1, bound);
+        if (next == FOUND) {
+            return FOUND;
+        }
+        if (next < least) {
+            least = next;
+        }
+    }
+    return least;
+}
+
+/**
+ * Function: before()
+ * ~~~~~~~~~~~~~~~~~~
+ * Heap order of the open list.
+ *
+ * inputs
+ * ~~~~~~
+ * x, y: Entries
+ *
+ * returns: true if x should leave the open list before y
+ **/
+static int before(Entry x, Entry y) {
+    return x.f < y.f || (x.f == y.f && x.g > y.g);
+}
+
+/**
+ * Function: pushO()
+ * ~~~~~~~~~~~~~~~~~
+ * Adds an Entry to the open list and bubbles it up.
+ *
+ * inputs
+ * ~~~~~~
+ * o: pointer to Open
+ * e: Entry to add
+ *
+ * returns: status
+ **/
+static int pushO(Open* o, Entry e) {
+    if (o->count == o->size) {
+        Entry* data = realloc(o->data, sizeof(Entry) * 2 * o->size);
+        if (data == NULL) {
+            return false;
+        }
+        o->data = data;
+        o->size *= 2;
+    }
+    long k = o->count++;
+    while (k > 0 && before(e, o->data[(k - 1) / 2])) {
+        o->data[k] = o->data[(k - 1) / 2];
+        k = (k - 1) / 2;
+    }
+    o->data[k] = e;
+    return true;
+}
+
+/**
+ * Function: popO()
+ * ~~~~~~~~~~~~~~~~
+ * Removes the first Entry from a non-empty open list and sifts the
+ * last Entry down into its place.
+ *
+ * input
+ * ~~~~~
+ * o: pointer to Open
+ *
+ * returns: first Entry
+ **/
+static Entry popO(Open* o) {
+    Entry top = o->data[0];
+    Entry e = o->data[--o->count];
+    long k = 0;
+    while (2 * k + 1 < o->count) {
+        long j = 2 * k + 1;
+        if (j + 1 < o->count && before(o->data[j + 1], o->data[j])) {
+            j++;
+        }
+        if (!before(o->data[j], e)) {
+            break;
+        }
+        o->data[k] = o->data[j];
+        k = j;
+    }
+    o->data[k] = e;
+    return top;
+}
@@ -0,0 +1,25 @@
+/**
+ * Astar.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for the informed (A* and IDA*) searches in pancake.
+ *
+ **/
+#ifndef ASTAR_H
+#define ASTAR_H
+
+#include "Bound.h"
+#include "Level.h"
+
+/* See Astar.c for full explanations */
+int astarSearch(Search* s, Bound* b, Word* goal, long* last);
+
+int idastarSearch(Search* s, Bound* b, unsigned char* initial,
+        unsigned char* goal, unsigned char** path);
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * Bound.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Implementation of the breakpoint lower bound used by the informed 
+ * searches in pancake.
+ *
+ **/
+#include <string.h>
+#include "Bound.h"
+
+/**
+ * Function: createB()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Records which pairs of symbols are adjacent in GOAL and how many edges 
+ * the largest flip can change.  No pattern database is attached.
+ *
+ * inputs
+ * ~~~~~~
+ * b: pointer to Bound struct
+ * goal: symbol indices of GOAL
+ * w: width of the pancake
+ * h: height of the pancake
+ * nSymbols: number of distinct symbols
+ *
+ * returns: status
+ **/
+int createB(Bound* b, unsigned char* goal, int w, int h, int nSymbols) {
+    b->width = w;
+    b->height = h;
+    b->nSymbols = nSymbols;
+    b->db = NULL;
+    b->across = calloc(nSymbols * nSymbols, 1);
+    b->down = calloc(nSymbols * nSymbols, 1);
+    if (b->across == NULL || b->down == NULL) {
+        return false;
+    }
+    for (int r = 0; r < h; r++) {
+        for (int c = 0; c < w; c++) {
+            int x = goal[r * w + c];
+            if (c + 1 < w) {
+                int y = goal[r * w + c + 1];
+                b->across[x * nSymbols + y] = b->across[y * nSymbols + x] = 1;
+            }
+            if (r + 1 < h) {
+                int y = goal[(r + 1) * w + c];
+                b->down[x * nSymbols + y] = b->down[y * nSymbols + x] = 1;
+            }
+        }
+    }
+    // A flip of the fw x fh block in the upper left corner changes the 
+    // fh edges along its right side (unless fw == w) and the fw edges 
+    // along its bottom (unless fh == h); every other edge keeps its 
+    // pair of symbols
+    b->repair = 1;
+    for (int fw = 1; fw <= w; fw++) {
+        for (int fh = 1; fh <= h; fh++) {
+            int changed = ((fw < w) ? fh : 0) + ((fh < h) ? fw : 0);
+            if (fw * fh > 1 && changed > b->repair) {
+                b->repair = changed;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Function: estimateB()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Lower bound on the number of flips from a configuration to GOAL: its 
+ * number of breakpoints divided by b->repair, rounded up.  Neighbors 
+ * differ by at most one, so the bound is also consistent.  The same 
+ * holds for a pattern database, and so for the larger of the two.
+ *
+ * inputs
+ * ~~~~~~
+ * b: pointer to Bound struct
+ * cells: symbol indices of the configuration
+ *
+ * returns: lower bound
+ **/
+int estimateB(Bound* b, unsigned char* cells) {
+    int w = b->width;
+    int breaks = 0;
+    for (int r = 0; r < b->height; r++) {
+        unsigned char* row = cells + r * w;
+        for (int c = 0; c < w; c++) {
+            if (c + 1 < w && !b->across[row[c] * b->nSymbols + row[c + 1]]) {
+                breaks++;
+            }
+            if (r + 1 < b->height 
+                    && !b->down[row[c] * b->nSymbols + row[c + w]]) {
+                breaks++;
+            }
+        }
+    }
+    int bound = (breaks + b->repair - 1) / b->repair;
+    if (b->db != NULL) {
+        int pattern = estimateD(b->db, cells);
+        if (pattern > bound) {
+            bound = pattern;
+        }
+    }
+    return bound;
+}
+
+/**
+ * Function: destroyB()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Frees all memory associated with a Bound.
+ *
+ * input
+ * ~~~~~
+ * b: pointer to Bound struct
+ *
+ * returns: status
+ **/
+int destroyB(Bound* b) {
+    free(b->across);
+    free(b->down);
+    return true;
+}
@@ -0,0 +1,56 @@
+/**
+ * Bound.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for admissible lower bounds on the number of flips 
+ * between a configuration and GOAL.
+ *
+ **/
+#ifndef BOUND_H
+#define BOUND_H
+
+#include "Database.h"
+
+/**
+ * Struct: Bound
+ * ~~~~~~~~~~~~~
+ * Breakpoint lower bound for a fixed GOAL.  An edge between two 
+ * horizontally (vertically) adjacent cells is a breakpoint if its pair 
+ * of symbols is not horizontally (vertically) adjacent anywhere in GOAL, 
+ * so GOAL itself has none.  A flip only changes the edges along the two 
+ * inner sides of the flipped block, so it can repair at most repair 
+ * breakpoints.  A pattern database may be attached, in which case the
+ * larger of the two bounds is used.
+ *
+ * members
+ * ~~~~~~~
+ * int width, height:   dimensions of the pancake
+ * int nSymbols:        number of distinct symbols
+ * int repair:          most breakpoints a single flip can change
+ * unsigned char* across:   nSymbols^2 flags, pairs adjacent in a row
+ * unsigned char* down:     nSymbols^2 flags, pairs adjacent in a column
+ * Database* db:        pattern database for GOAL (NULL if none)
+ **/
+typedef struct Bound {
+    int width;
+    int height;
+    int nSymbols;
+    int repair;
+    unsigned char* across;
+    unsigned char* down;
+    Database* db;
+} Bound;
+
+/* See Bound.c for full explanations */
+int createB(Bound* b, unsigned char* goal, int w, int h, int nSymbols);
+
+int estimateB(Bound* b, unsigned char* cells);
+
+int destroyB(Bound* b);
+
+#endif
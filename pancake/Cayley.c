@@ -0,0 +1,294 @@
+/**
+ * Cayley.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Implementation of exhaustive distance tables.  A single breadth-first 
+ * search from the identity over all n! permutations fills a table that 
+ * is written once and then mapped read-only, after which every query 
+ * on the board is a lookup.
+ *
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Cayley.h"
+#include "Flip.h"
+
+static int getDist(unsigned char* dist, Word rank);
+static void setDist(unsigned char* dist, Word rank, int d);
+static Word factorial(int n);
+
+/**
+ * Function: buildC()
+ * ~~~~~~~~~~~~~~~~~~
+ * Fills a table by breadth-first search from the identity.  Every flip 
+ * is its own inverse, so distances from the identity are also distances 
+ * to it.  The table doubles as the frontier: level k is every entry 
+ * holding k, found by scanning the whole table, so no queue is needed.
+ *
+ * inputs
+ * ~~~~~~
+ * c: pointer to Cayley struct
+ * w, h: dimensions of the pancake (at most MAXCAYLEYN cells)
+ *
+ * returns: status (false if memory ran out, or some distance does not 
+ *          fit in 4 bits)
+ **/
+int buildC(Cayley* c, int w, int h) {
+    c->width = w;
+    c->height = h;
+    c->n = w * h;
+    c->base = NULL;
+    c->length = 0;
+    c->dist = NULL;
+    if (c->n > MAXCAYLEYN) {
+        return false;
+    }
+    c->entries = factorial(c->n);
+    int nStep = countMoves(w, h);
+    Move* moves = malloc(sizeof(Move) * (nStep + 1));
+    c->dist = malloc((c->entries + 1) / 2);
+    if (moves == NULL || c->dist == NULL) {
+        free(moves);
+        return false;
+    }
+    listMoves(w, h, moves);
+    memset(c->dist, 0xFF, (c->entries + 1) / 2);
+    unsigned char cur[c->n];
+    unsigned char next[c->n];
+    for (int i = 0; i < c->n; i++) {
+        cur[i] = i;
+    }
+    setDist(c->dist, rankP(cur, c->n), 0);
+
+    int ok = true;
+    long added = 1;
+    for (int depth = 0; added > 0; depth++) {
+        added = 0;
+        for (Word r = 0; r < c->entries; r++) {
+            if (getDist(c->dist, r) != depth) {
+                continue;
+            }
+            unrankP(r, c->n, cur);
+            for (int i = 0; i < nStep; i++) {
+                Move m = moves[i];
+                flipPancake(cur, next, w, h, m.fw, m.fh, m.v);
+                Word q = rankP(next, c->n);
+                if (getDist(c->dist, q) == FAR) {
+                    setDist(c->dist, q, depth + 1);
+                    added++;
+                }
+            }
+        }
+        // The next level would not fit in 4 bits
+        if (added > 0 && depth + 1 == FAR) {
+            ok = false;
+            break;
+        }
+    }
+    free(moves);
+    return ok;
+}
+
+/**
+ * Function: saveC()
+ * ~~~~~~~~~~~~~~~~~
+ * Writes a table to a file, behind a CayleyHeader.
+ *
+ * inputs
+ * ~~~~~~
+ * c: pointer to Cayley struct (with its table)
+ * file: name of the file
+ *
+ * returns: status
+ **/
+int saveC(Cayley* c, char* file) {
+    CayleyHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CAYLEYMAGIC, sizeof(header.magic));
+    header.width = c->width;
+    header.height = c->height;
+    header.entries = c->entries;
+    FILE* out = fopen(file, "wb");
+    if (out == NULL) {
+        return false;
+    }
+    Word bytes = (c->entries + 1) / 2;
+    int ok = fwrite(&header, sizeof(header), 1, out) == 1
+            && fwrite(c->dist, 1, bytes, out) == bytes;
+    return fclose(out) == 0 && ok;
+}
+
+/**
+ * Function: loadC()
+ * ~~~~~~~~~~~~~~~~~
+ * Maps a table written by saveC() into memory.
+ *
+ * inputs
+ * ~~~~~~
+ * c: pointer to Cayley struct
+ * w, h: dimensions of the pancake
+ * file: name of the file
+ *
+ * returns: status (false unless the file is a table for this board)
+ **/
+int loadC(Cayley* c, int w, int h, char* file) {
+    c->width = w;
+    c->height = h;
+    c->n = w * h;
+    if (c->n > MAXCAYLEYN) {
+        return false;
+    }
+    c->entries = factorial(c->n);
+    int fd = open(file, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t) sizeof(CayleyHeader)) {
+        close(fd);
+        return false;
+    }
+    void* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    CayleyHeader* header = base;
+    if (memcmp(header->magic, CAYLEYMAGIC, sizeof(header->magic))
+            || header->width != w || header->height != h
+            || header->entries != c->entries
+            || (Word) st.st_size 
+                != sizeof(CayleyHeader) + (c->entries + 1) / 2) {
+        munmap(base, st.st_size);
+        return false;
+    }
+    c->base = base;
+    c->length = st.st_size;
+    c->dist = (unsigned char*) base + sizeof(CayleyHeader);
+    return true;
+}
+
+/**
+ * Function: relabelC()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Renames the symbols of a configuration so that GOAL becomes the 
+ * identity: the symbol in cell i of GOAL becomes i.
+ *
+ * inputs
+ * ~~~~~~
+ * cells: symbol indices of the configuration
+ * goal: symbol indices of GOAL (all distinct)
+ * n: number of cells
+ * perm: array of n cells to fill
+ *
+ * returns: nothing
+ **/
+void relabelC(unsigned char* cells, unsigned char* goal, int n, 
+        unsigned char* perm) {
+    unsigned char name[NCHARS];
+    for (int i = 0; i < n; i++) {
+        name[goal[i]] = i;
+    }
+    for (int i = 0; i < n; i++) {
+        perm[i] = name[cells[i]];
+    }
+}
+
+/**
+ * Function: distanceC()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Looks up the distance of a permutation from the identity.
+ *
+ * inputs
+ * ~~~~~~
+ * c: pointer to Cayley struct (with its table)
+ * perm: a permutation of 0 ... n-1
+ *
+ * returns: number of flips, FAR if the identity cannot be reached
+ **/
+int distanceC(Cayley* c, unsigned char* perm) {
+    return getDist(c->dist, rankP(perm, c->n));
+}
+
+/**
+ * Function: destroyC()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Unmaps or frees the table of a Cayley struct.
+ *
+ * input
+ * ~~~~~
+ * c: pointer to Cayley struct
+ *
+ * returns: status
+ **/
+int destroyC(Cayley* c) {
+    if (c->base != NULL) {
+        munmap(c->base, c->length);
+    } else {
+        free(c->dist);
+    }
+    c->dist = NULL;
+    c->base = NULL;
+    return true;
+}
+
+/**
+ * Function: getDist()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Reads the 4-bit distance of a rank.
+ *
+ * inputs
+ * ~~~~~~
+ * dist: packed distances
+ * rank: rank of the permutation
+ *
+ * returns: distance
+ **/
+static int getDist(unsigned char* dist, Word rank) {
+    return (dist[rank / 2] >> ((rank % 2) * 4)) & FAR;
+}
+
+/**
+ * Function: setDist()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Writes the 4-bit distance of a rank.
+ *
+ * inputs
+ * ~~~~~~
+ * dist: packed distances
+ * rank: rank of the permutation
+ * d: distance, from 0 to FAR
+ *
+ * returns: nothing
+ **/
+static void setDist(unsigned char* dist, Word rank, int d) {
+    int shift = (rank % 2) * 4;
+    dist[rank / 2] = (dist[rank / 2] & ~(FAR << shift)) | (d << shift);
+}
+
+/**
+ * Function: factorial()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * input
+ * ~~~~~
+ * n: a small non-negative integer
+ *
+ * returns: n!
+ **/
+static Word factorial(int n) {
+    Word f = 1;
+    for (int i = 2; i <= n; i++) {
+        f *= i;
+    }
+    return f;
+}
@@ -0,0 +1,87 @@
+/**
+ * Cayley.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for exhaustive distance tables of small boards with 
+ * distinct symbols.
+ *
+ **/
+#ifndef CAYLEY_H
+#define CAYLEY_H
+
+#include "Packing.h"
+
+// First bytes of every distance table file
+#define CAYLEYMAGIC "PANCTAB1"
+// Largest number of cells a table is built for (12! entries)
+#define MAXCAYLEYN 12
+// Distances are stored in 4 bits; FAR marks a permutation not reached
+#define FAR 15
+
+/**
+ * Struct: CayleyHeader
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Start of a distance table file.  The distances, two per byte (the 
+ * even rank in the low nibble) in order of rank, follow directly.
+ *
+ * members
+ * ~~~~~~~
+ * char magic[]:    CAYLEYMAGIC
+ * int width, height:   dimensions of the pancake
+ * Word entries:    number of permutations (n!)
+ **/
+typedef struct CayleyHeader {
+    char magic[8];
+    int width;
+    int height;
+    Word entries;
+} CayleyHeader;
+
+/**
+ * Struct: Cayley
+ * ~~~~~~~~~~~~~~
+ * Distance from every permutation of 0 ... n-1 to the identity, indexed 
+ * by rankP().  Flips only move cells around, so the distance between 
+ * any two configurations of distinct symbols is that of the first one 
+ * after relabeling the second one as the identity: one table answers 
+ * every pair on a board.
+ *
+ * members
+ * ~~~~~~~
+ * int width, height:   dimensions of the pancake
+ * int n:               number of cells
+ * Word entries:        number of permutations (n!)
+ * unsigned char* dist: (entries + 1) / 2 bytes of 4-bit distances
+ * void* base:          mapped file (NULL if dist was allocated)
+ * size_t length:       length of the mapping
+ **/
+typedef struct Cayley {
+    int width;
+    int height;
+    int n;
+    Word entries;
+    unsigned char* dist;
+    void* base;
+    size_t length;
+} Cayley;
+
+/* See Cayley.c for full explanations */
+int buildC(Cayley* c, int w, int h);
+
+int saveC(Cayley* c, char* file);
+
+int loadC(Cayley* c, int w, int h, char* file);
+
+void relabelC(unsigned char* cells, unsigned char* goal, int n, 
+        unsigned char* perm);
+
+int distanceC(Cayley* c, unsigned char* perm);
+
+int destroyC(Cayley* c);
+
+#endif
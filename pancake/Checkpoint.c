@@ -0,0 +1,378 @@
+/**
+ * Checkpoint.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Checkpoints of a bidirectional BFS.  Everything a search knows is in
+ * the Nodes of its two ends, which only ever grow at the back, plus the
+ * frontier and depth of each end; the table is rebuilt from the nodes
+ * when the search is resumed.  A checkpoint file is a CkHeader followed
+ * by segments of nodes, and each checkpoint only appends the nodes added
+ * since the one before, so the whole search is written about once.  The
+ * segments are flushed to disk before the header that counts them, so
+ * a search stopped halfway through a checkpoint resumes from the one
+ * before.
+ *
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Checkpoint.h"
+
+static int writeSegment(int fd, Nodes* nd, long first, int firstLevel,
+        long* end);
+static int replaySegment(Search* s, char** at, char* stop);
+static int writeAll(int fd, void* buf, long bytes, long* end);
+static long padded(long bytes);
+
+/**
+ * Function: createK()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Starts a checkpoint file, which is not written until the first call
+ * to saveK().
+ *
+ * inputs
+ * ~~~~~~
+ * ck: pointer to Checkpoint struct
+ * file: name of the file (NULL to write none)
+ * every: seconds between checkpoints
+ *
+ * returns: nothing
+ **/
+void createK(Checkpoint* ck, char* file, double every) {
+    ck->file = file;
+    ck->initial = ck->goal = NULL;
+    ck->every = every;
+    ck->last = seconds();
+    ck->end = 0;
+    ck->saved[0] = ck->saved[1] = 0;
+    ck->levels[0] = ck->levels[1] = 0;
+}
+
+/**
+ * Function: dueK()
+ * ~~~~~~~~~~~~~~~~
+ * Tells whether it is time for another checkpoint.
+ *
+ * input
+ * ~~~~~
+ * ck: pointer to Checkpoint struct (or NULL)
+ *
+ * returns: true if ck has a file and the last checkpoint is at least
+ *          ck->every seconds old
+ **/
+int dueK(Checkpoint* ck) {
+    return ck != NULL && ck->file != NULL
+            && seconds() - ck->last >= ck->every;
+}
+
+/**
+ * Function: saveK()
+ * ~~~~~~~~~~~~~~~~~
+ * Appends the nodes of both ends added since the last checkpoint to the
+ * file, then rewrites its header.  Both ends must have stopped after
+ * complete levels.
+ *
+ * inputs
+ * ~~~~~~
+ * ck: pointer to Checkpoint struct (with initial and goal set)
+ * s: pointer to Search
+ * level: frontier of INITIAL's and GOAL's end
+ * depth: number of levels each end has expanded
+ *
+ * returns: status (on failure the file still holds the last checkpoint
+ *          that succeeded)
+ **/
+int saveK(Checkpoint* ck, Search* s, Frontier level[2], int depth[2]) {
+    ck->last = seconds();
+    int fresh = (ck->end == 0);
+    int fd = open(ck->file, O_WRONLY | O_CREAT | (fresh ? O_TRUNC : 0),
+            0644);
+    if (fd < 0) {
+        return false;
+    }
+    long end = fresh ? sizeof(CkHeader) : ck->end;
+    int ok = true;
+    for (int a = 0; ok && a < 2; a++) {
+        Nodes* nd = s->nodes[a];
+        if (nd->count > ck->saved[a] || nd->nLevels > ck->levels[a]) {
+            ok = writeSegment(fd, nd, ck->saved[a], ck->levels[a], &end);
+        }
+    }
+    // The segments reach the disk before the header that counts them
+    ok = ok && fdatasync(fd) == 0;
+    if (ok) {
+        CkHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, CKMAGIC, sizeof(header.magic));
+        header.width = s->width;
+        header.height = s->height;
+        header.keyWidth = s->pk->width;
+        for (int a = 0; a < 2; a++) {
+            header.depth[a] = depth[a];
+            header.nLevels[a] = s->nodes[a]->nLevels;
+            header.lo[a] = level[a].lo;
+            header.hi[a] = level[a].hi;
+            header.count[a] = s->nodes[a]->count;
+        }
+        header.end = end;
+        strncpy(header.initial, ck->initial, CKCELLS);
+        strncpy(header.goal, ck->goal, CKCELLS);
+        long at = 0;
+        ok = writeAll(fd, &header, sizeof(header), &at)
+                && ftruncate(fd, end) == 0 && fdatasync(fd) == 0;
+    }
+    ok = (close(fd) == 0) && ok;
+    if (ok) {
+        ck->end = end;
+        for (int a = 0; a < 2; a++) {
+            ck->saved[a] = s->nodes[a]->count;
+            ck->levels[a] = s->nodes[a]->nLevels;
+        }
+    }
+    return ok;
+}
+
+/**
+ * Function: loadK()
+ * ~~~~~~~~~~~~~~~~~
+ * Maps a checkpoint file into memory and adds the nodes it holds to
+ * both ends of a search, and to the table.  If the file is also the one
+ * ck writes, later checkpoints carry on appending to it.
+ *
+ * inputs
+ * ~~~~~~
+ * ck: pointer to Checkpoint struct (with initial and goal set)
+ * file: name of the file
+ * s: pointer to Search whose Nodes and table only hold the two roots
+ * level: where to store the frontier of each end
+ * depth: where to store the number of levels each end has expanded
+ *
+ * returns: 1 if the search was restored, 0 if file is not a checkpoint
+ *          of this search, -1 if memory ran out
+ **/
+int loadK(Checkpoint* ck, char* file, Search* s, Frontier level[2],
+        int depth[2]) {
+    int fd = open(file, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t) sizeof(CkHeader)) {
+        close(fd);
+        return 0;
+    }
+    void* base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return 0;
+    }
+    CkHeader* header = base;
+    int ok = !memcmp(header->magic, CKMAGIC, sizeof(header->magic))
+            && header->width == s->width && header->height == s->height
+            && header->keyWidth == s->pk->width
+            && header->end >= (long) sizeof(CkHeader)
+            && header->end <= st.st_size
+            && header->initial[CKCELLS] == '\0'
+            && header->goal[CKCELLS] == '\0'
+            && !strcmp(header->initial, ck->initial)
+            && !strcmp(header->goal, ck->goal);
+    char* at = (char*) base + sizeof(CkHeader);
+    char* stop = (char*) base + header->end;
+    while (ok > 0 && at < stop) {
+        ok = replaySegment(s, &at, stop);
+    }
+    for (int a = 0; ok > 0 && a < 2; a++) {
+        Nodes* nd = s->nodes[a];
+        ok = nd->count == header->count[a]
+                && nd->nLevels == header->nLevels[a]
+                && header->lo[a] >= 0 && header->lo[a] <= header->hi[a]
+                && header->hi[a] <= nd->count && header->depth[a] >= 0;
+        level[a].lo = header->lo[a];
+        level[a].hi = header->hi[a];
+        depth[a] = header->depth[a];
+    }
+    // The roots are already in the table
+    if (ok > 0 && !reserveH(s->dict, header->count[0] + header->count[1])) {
+        ok = -1;
+    }
+    for (int a = 0; ok > 0 && a < 2; a++) {
+        Nodes* nd = s->nodes[a];
+        for (long i = 1; ok > 0 && i < nd->count; i++) {
+            // A key already there makes the file invalid
+            ok = addH(s->dict, configN(nd, i), refN(a, i));
+        }
+    }
+    if (ok > 0 && ck->file != NULL && !strcmp(ck->file, file)) {
+        ck->end = header->end;
+        for (int a = 0; a < 2; a++) {
+            ck->saved[a] = header->count[a];
+            ck->levels[a] = header->nLevels[a];
+        }
+    }
+    munmap(base, st.st_size);
+    return ok;
+}
+
+/**
+ * Function: writeSegment()
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ * Writes the nodes of one end from a given one on as a segment.
+ *
+ * inputs
+ * ~~~~~~
+ * fd: file descriptor
+ * nd: pointer to Nodes
+ * first: first node to write
+ * firstLevel: first level start to write
+ * end: offset to write at, advanced past the segment
+ *
+ * returns: status
+ **/
+static int writeSegment(int fd, Nodes* nd, long first, int firstLevel,
+        long* end) {
+    CkSegment seg;
+    memset(&seg, 0, sizeof(seg));
+    seg.side = nd->side;
+    seg.nStarts = nd->nLevels - firstLevel;
+    seg.first = first;
+    seg.count = nd->count - first;
+    int ok = writeAll(fd, &seg, sizeof(seg), end)
+            && writeAll(fd, nd->start + firstLevel,
+                    sizeof(long) * seg.nStarts, end);
+    // Keys, then moves, a block's worth at a time
+    for (long i = first; ok && i < nd->count; i = (i | NODEMASK) + 1) {
+        long run = ((i | NODEMASK) + 1 < nd->count)
+                ? (i | NODEMASK) + 1 - i : nd->count - i;
+        ok = writeAll(fd, configN(nd, i), sizeof(Word) * nd->width * run,
+                end);
+    }
+    for (long i = first; ok && i < nd->count; i = (i | NODEMASK) + 1) {
+        long run = ((i | NODEMASK) + 1 < nd->count)
+                ? (i | NODEMASK) + 1 - i : nd->count - i;
+        ok = writeAll(fd, &moveN(nd, i), sizeof(unsigned short) * run,
+                end);
+    }
+    long bytes = sizeof(unsigned short) * seg.count;
+    char zero[8] = {0};
+    return ok && writeAll(fd, zero, padded(bytes) - bytes, end);
+}
+
+/**
+ * Function: replaySegment()
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Adds the nodes of a segment to their end, starting levels where they
+ * were started.  A segment from node 0 on must start with the root the
+ * end already has.
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search
+ * at: position of the segment in the mapped file, advanced past it
+ * stop: end of the segments
+ *
+ * returns: 1 if the segment was added, 0 if it is invalid, -1 if memory
+ *          ran out
+ **/
+static int replaySegment(Search* s, char** at, char* stop) {
+    if (stop - *at < (long) sizeof(CkSegment)) {
+        return 0;
+    }
+    CkSegment* seg = (CkSegment*) *at;
+    if (seg->side < 0 || seg->side > 1 || seg->nStarts < 0
+            || seg->count < 0 || seg->first < 0) {
+        return 0;
+    }
+    Nodes* nd = s->nodes[seg->side];
+    int width = nd->width;
+    long* starts = (long*) (seg + 1);
+    Word* keys = (Word*) (starts + seg->nStarts);
+    long keyBytes = sizeof(Word) * width * seg->count;
+    long moveBytes = sizeof(unsigned short) * seg->count;
+    long bytes = sizeof(CkSegment) + sizeof(long) * seg->nStarts
+            + keyBytes + padded(moveBytes);
+    if (bytes > stop - *at
+            || (seg->first != nd->count && (seg->first != 0
+                || nd->count != 1 || seg->count == 0
+                || !sameP(keys, configN(nd, 0), width)))) {
+        return 0;
+    }
+    unsigned short* moves = (unsigned short*) ((char*) keys + keyBytes);
+    long last = (nd->nLevels > 0) ? nd->start[nd->nLevels - 1] : 0;
+    for (int k = 0; k < seg->nStarts; k++) {
+        if (starts[k] < last || starts[k] < 1 || starts[k] < seg->first
+                || starts[k] > seg->first + seg->count) {
+            return 0;
+        }
+        last = starts[k];
+    }
+    int k = 0;
+    for (long i = seg->first; i <= seg->first + seg->count; i++) {
+        while (k < seg->nStarts && starts[k] == i) {
+            if (!levelN(nd)) {
+                return -1;
+            }
+            k++;
+        }
+        // The root is already there
+        if (i > 0 && i < seg->first + seg->count && addN(nd,
+                keys + (i - seg->first) * width,
+                moves[i - seg->first]) < 0) {
+            return -1;
+        }
+    }
+    *at += bytes;
+    return 1;
+}
+
+/**
+ * Function: writeAll()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Writes a buffer at an offset of a file, however many calls to
+ * pwrite() it takes.
+ *
+ * inputs
+ * ~~~~~~
+ * fd: file descriptor
+ * buf: bytes to write
+ * bytes: number of bytes
+ * end: offset to write at, advanced past them
+ *
+ * returns: status
+ **/
+static int writeAll(int fd, void* buf, long bytes, long* end) {
+    char* p = buf;
+    while (bytes > 0) {
+        ssize_t done = pwrite(fd, p, bytes, *end);
+        if (done <= 0) {
+            return false;
+        }
+        p += done;
+        bytes -= done;
+        *end += done;
+    }
+    return true;
+}
+
+/**
+ * Function: padded()
+ * ~~~~~~~~~~~~~~~~~~
+ * Rounds a number of bytes up to a multiple of 8, so that every segment
+ * starts aligned for its longs and Words.
+ *
+ * input
+ * ~~~~~
+ * bytes: number of bytes
+ *
+ * returns: the rounded number
+ **/
+static long padded(long bytes) {
+    return (bytes + 7) & ~7L;
+}
@@ -0,0 +1,118 @@
+/**
+ * Checkpoint.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for checkpoints of a bidirectional BFS, from which a
+ * search that was stopped can carry on.
+ *
+ **/
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "Level.h"
+
+// First bytes of every checkpoint file
+#define CKMAGIC "PANCCKP1"
+// Most cells of a configuration kept in a checkpoint
+#define CKCELLS 256
+
+/**
+ * Struct: CkHeader
+ * ~~~~~~~~~~~~~~~~
+ * Start of a checkpoint file.  Segments follow it, each a CkSegment and
+ * then its level starts, keys and moves, up to byte end; anything past
+ * end is left over from a checkpoint that never finished.
+ *
+ * members
+ * ~~~~~~~
+ * char magic[]:        CKMAGIC
+ * int width, height:   dimensions of the pancake
+ * int keyWidth:        number of Words in every key
+ * int depth[]:         number of levels each end has expanded
+ * int nLevels[]:       number of levels each Nodes has started
+ * long lo[], hi[]:     frontier of each end
+ * long count[]:        number of nodes of each end
+ * long end:            bytes of the file in use
+ * char initial[], goal[]:  INITIAL and GOAL
+ **/
+typedef struct CkHeader {
+    char magic[8];
+    int width;
+    int height;
+    int keyWidth;
+    int depth[2];
+    int nLevels[2];
+    long lo[2];
+    long hi[2];
+    long count[2];
+    long end;
+    char initial[CKCELLS + 1];
+    char goal[CKCELLS + 1];
+} CkHeader;
+
+/**
+ * Struct: CkSegment
+ * ~~~~~~~~~~~~~~~~~
+ * Nodes of one end added since the checkpoint before.  It is followed
+ * by nStarts longs (the levels started meanwhile, see levelN()), count
+ * keys and count moves, padded to a multiple of 8 bytes.
+ *
+ * members
+ * ~~~~~~~
+ * int side:    0 for INITIAL's end, 1 for GOAL's
+ * int nStarts: number of levels started
+ * long first:  index of the first node
+ * long count:  number of nodes
+ **/
+typedef struct CkSegment {
+    int side;
+    int nStarts;
+    long first;
+    long count;
+} CkSegment;
+
+/**
+ * Struct: Checkpoint
+ * ~~~~~~~~~~~~~~~~~~
+ * A checkpoint file being written.  Nodes are only ever appended, so
+ * each checkpoint appends the nodes added since the one before, and
+ * then rewrites the header.
+ *
+ * members
+ * ~~~~~~~
+ * char* file:      name of the file (NULL if none is written)
+ * char* initial:   INITIAL of the search
+ * char* goal:      GOAL of the search
+ * double every:    seconds between checkpoints
+ * double last:     time of the last one (see seconds())
+ * long end:        bytes of the file in use (0 before the first)
+ * long saved[]:    number of nodes of each end in the file
+ * int levels[]:    number of levels of each end in the file
+ **/
+typedef struct Checkpoint {
+    char* file;
+    char* initial;
+    char* goal;
+    double every;
+    double last;
+    long end;
+    long saved[2];
+    int levels[2];
+} Checkpoint;
+
+/* See Checkpoint.c for full explanations */
+void createK(Checkpoint* ck, char* file, double every);
+
+int dueK(Checkpoint* ck);
+
+int saveK(Checkpoint* ck, Search* s, Frontier level[2], int depth[2]);
+
+int loadK(Checkpoint* ck, char* file, Search* s, Frontier level[2],
+        int depth[2]);
+
+#endif
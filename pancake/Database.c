@@ -0,0 +1,288 @@
+/**
+ * Database.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Implementation of pattern databases.  Abstract configurations are
+ * numbered by their rank among all arrangements of the same multiset
+ * of abstract symbols, so a table needs one byte per arrangement and
+ * no keys at all.  Tables are written once and then mapped read-only,
+ * so every search on the same board shares the same pages.
+ *
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Database.h"
+
+/**
+ * Function: createD()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Sets up the abstraction described by abstract for configurations
+ * packed with pk.  The table itself is left to the caller.
+ *
+ * inputs
+ * ~~~~~~
+ * d: pointer to Database struct
+ * pk: pointer to Packing of the configurations
+ * goal: string of GOAL
+ * abstract: GOAL with every cell outside the pattern set to '\0'
+ *
+ * returns: status (false if goal does not abstract to abstract, or
+ *          the table would be too large)
+ **/
+int createD(Database* d, Packing* pk, char* goal, char* abstract) {
+    d->n = pk->n;
+    d->dist = NULL;
+    d->base = NULL;
+    d->length = 0;
+    if (d->n > MAXCELLS) {
+        return false;
+    }
+    // Symbols in the pattern are numbered 1, 2, ... in character order
+    bool inPattern[NCHARS];
+    memset(inPattern, 0, sizeof(inPattern));
+    for (int i = 0; i < d->n; i++) {
+        inPattern[(unsigned char) abstract[i]] = true;
+    }
+    for (int i = 0; i < d->n; i++) {
+        unsigned char c = goal[i];
+        if (abstract[i] != '\0' ? abstract[i] != goal[i] : inPattern[c]) {
+            return false;
+        }
+    }
+    d->nAbstract = 1;
+    memset(d->map, 0, sizeof(d->map));
+    for (int c = 1; c < NCHARS; c++) {
+        if (inPattern[c]) {
+            d->map[pk->index[c]] = d->nAbstract++;
+        }
+    }
+    memset(d->count, 0, sizeof(d->count));
+    for (int i = 0; i < d->n; i++) {
+        d->count[d->map[pk->index[(unsigned char) goal[i]]]]++;
+    }
+    // entries = n! / (count[0]! count[1]! ...), built up one cell at a
+    // time so that it never exceeds its final value
+    d->entries = 1;
+    int cells = 0;
+    for (int a = 0; a < d->nAbstract; a++) {
+        for (int j = 1; j <= d->count[a]; j++) {
+            d->entries = d->entries * ++cells / j;
+            if (d->entries > MAXENTRIES) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Function: abstractD()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Replaces every symbol index of a configuration by its abstract
+ * symbol.
+ *
+ * inputs
+ * ~~~~~~
+ * d: pointer to Database struct
+ * cells: symbol indices of the configuration
+ * abstract: array of n abstract symbols to fill
+ *
+ * returns: nothing
+ **/
+void abstractD(Database* d, unsigned char* cells, unsigned char* abstract) {
+    for (int i = 0; i < d->n; i++) {
+        abstract[i] = d->map[cells[i]];
+    }
+}
+
+/**
+ * Function: rankD()
+ * ~~~~~~~~~~~~~~~~~
+ * Position of an abstract configuration in the lexicographic order of
+ * all arrangements of its multiset.  Every arrangement that agrees on
+ * the first i cells and has a smaller symbol in cell i comes first; of
+ * the total arrangements of the remaining rem cells, a fraction
+ * count[s] / rem has symbol s in cell i.
+ *
+ * inputs
+ * ~~~~~~
+ * d: pointer to Database struct
+ * abstract: n abstract symbols
+ *
+ * returns: rank, from 0 to d->entries - 1
+ **/
+Word rankD(Database* d, unsigned char* abstract) {
+    int count[d->nAbstract];
+    memcpy(count, d->count, sizeof(count));
+    Word total = d->entries;
+    Word rank = 0;
+    for (int i = 0, rem = d->n; i < d->n; i++, rem--) {
+        int x = abstract[i];
+        for (int s = 0; s < x; s++) {
+            rank += total * count[s] / rem;
+        }
+        total = total * count[x] / rem;
+        count[x]--;
+    }
+    return rank;
+}
+
+/**
+ * Function: unrankD()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Inverse of rankD().
+ *
+ * inputs
+ * ~~~~~~
+ * d: pointer to Database struct
+ * rank: rank, from 0 to d->entries - 1
+ * abstract: array of n abstract symbols to fill
+ *
+ * returns: nothing
+ **/
+void unrankD(Database* d, Word rank, unsigned char* abstract) {
+    int count[d->nAbstract];
+    memcpy(count, d->count, sizeof(count));
+    Word total = d->entries;
+    for (int i = 0, rem = d->n; i < d->n; i++, rem--) {
+        int x = 0;
+        Word part = total * count[x] / rem;
+        while (rank >= part) {
+            rank -= part;
+            x++;
+            part = total * count[x] / rem;
+        }
+        abstract[i] = x;
+        total = part;
+        count[x]--;
+    }
+}
+
+/**
+ * Function: estimateD()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Lower bound on the number of flips from a configuration to GOAL: the
+ * distance of its abstraction.
+ *
+ * inputs
+ * ~~~~~~
+ * d: pointer to Database struct (with its table)
+ * cells: symbol indices of the configuration
+ *
+ * returns: lower bound, NOPATH if GOAL cannot be reached
+ **/
+int estimateD(Database* d, unsigned char* cells) {
+    unsigned char abstract[d->n];
+    abstractD(d, cells, abstract);
+    int dist = d->dist[rankD(d, abstract)];
+    return (dist == UNSEEN) ? NOPATH : dist;
+}
+
+/**
+ * Function: saveD()
+ * ~~~~~~~~~~~~~~~~~
+ * Writes the table of a Database to a file, behind a DbHeader.
+ *
+ * inputs
+ * ~~~~~~
+ * d: pointer to Database struct (with its table)
+ * file: name of the file
+ * w, h: dimensions of the pancake
+ * abstract: GOAL with every cell outside the pattern set to '\0'
+ *
+ * returns: status
+ **/
+int saveD(Database* d, char* file, int w, int h, char* abstract) {
+    DbHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DBMAGIC, sizeof(header.magic));
+    header.width = w;
+    header.height = h;
+    header.entries = d->entries;
+    memcpy(header.goal, abstract, d->n);
+    FILE* out = fopen(file, "wb");
+    if (out == NULL) {
+        return false;
+    }
+    int ok = fwrite(&header, sizeof(header), 1, out) == 1
+            && fwrite(d->dist, 1, d->entries, out) == d->entries;
+    return fclose(out) == 0 && ok;
+}
+
+/**
+ * Function: loadD()
+ * ~~~~~~~~~~~~~~~~~
+ * Maps a table written by saveD() into memory and sets up its
+ * abstraction for configurations packed with pk.
+ *
+ * inputs
+ * ~~~~~~
+ * d: pointer to Database struct
+ * pk: pointer to Packing of the configurations
+ * goal: string of GOAL
+ * w, h: dimensions of the pancake
+ * file: name of the file
+ *
+ * returns: status (false unless the file is a table for this GOAL)
+ **/
+int loadD(Database* d, Packing* pk, char* goal, int w, int h, char* file) {
+    int fd = open(file, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < (off_t) sizeof(DbHeader)) {
+        close(fd);
+        return false;
+    }
+    void* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    DbHeader* header = base;
+    if (memcmp(header->magic, DBMAGIC, sizeof(header->magic))
+            || header->width != w || header->height != h
+            || !createD(d, pk, goal, header->goal)
+            || header->entries != d->entries
+            || (Word) st.st_size != sizeof(DbHeader) + d->entries) {
+        munmap(base, st.st_size);
+        return false;
+    }
+    d->base = base;
+    d->length = st.st_size;
+    d->dist = (unsigned char*) base + sizeof(DbHeader);
+    return true;
+}
+
+/**
+ * Function: destroyD()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Unmaps or frees the table of a Database.
+ *
+ * input
+ * ~~~~~
+ * d: pointer to Database struct
+ *
+ * returns: status
+ **/
+int destroyD(Database* d) {
+    if (d->base != NULL) {
+        munmap(d->base, d->length);
+    } else {
+        free(d->dist);
+    }
+    d->dist = NULL;
+    d->base = NULL;
+    return true;
+}
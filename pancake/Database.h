@@ -0,0 +1,101 @@
+/**
+ * Database.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for pattern databases: tables of exact distances to an
+ * abstraction of GOAL, built once by mkpdb and mapped into pancake.
+ *
+ **/
+#ifndef DATABASE_H
+#define DATABASE_H
+
+#include <limits.h>
+#include "Packing.h"
+
+// First bytes of every pattern database file
+#define DBMAGIC "PANCPDB1"
+// Largest number of cells in a configuration
+#define MAXCELLS 256
+// Largest number of abstract configurations in a table
+#define MAXENTRIES ((Word) 1 << 32)
+// Distance stored for abstract configurations that cannot reach GOAL
+#define UNSEEN 255
+// Lower bound returned for configurations that cannot reach GOAL
+#define NOPATH (INT_MAX / 2)
+
+/**
+ * Struct: DbHeader
+ * ~~~~~~~~~~~~~~~~
+ * Start of a pattern database file.  The table of distances, one byte
+ * per abstract configuration in order of rank, follows directly.
+ *
+ * members
+ * ~~~~~~~
+ * char magic[]:    DBMAGIC
+ * int width, height:   dimensions of the pancake
+ * Word entries:    number of abstract configurations
+ * char goal[]:     GOAL with every cell outside the pattern set to '\0'
+ **/
+typedef struct DbHeader {
+    char magic[8];
+    int width;
+    int height;
+    Word entries;
+    char goal[MAXCELLS];
+} DbHeader;
+
+/**
+ * Struct: Database
+ * ~~~~~~~~~~~~~~~~
+ * An abstraction of the configurations of a pancake, in which the
+ * symbols of a pattern stay distinct and all others become the blank
+ * (abstract symbol 0), and the distance of every abstract configuration
+ * from the abstraction of GOAL.  Since a flip only moves cells around,
+ * every path between configurations is also a path between their
+ * abstractions, so these distances are consistent lower bounds.
+ *
+ * members
+ * ~~~~~~~
+ * int n:               number of cells
+ * int nAbstract:       number of abstract symbols, including the blank
+ * unsigned char map[]: abstract symbol for each symbol index
+ * int count[]:         number of cells holding each abstract symbol
+ * Word entries:        number of abstract configurations
+ * unsigned char* dist: distance of each abstract configuration by rank
+ * void* base:          mapped file (NULL if dist was allocated)
+ * size_t length:       length of the mapping
+ **/
+typedef struct Database {
+    int n;
+    int nAbstract;
+    unsigned char map[NCHARS];
+    int count[NCHARS];
+    Word entries;
+    unsigned char* dist;
+    void* base;
+    size_t length;
+} Database;
+
+/* See Database.c for full explanations */
+int createD(Database* d, Packing* pk, char* goal, char* abstract);
+
+void abstractD(Database* d, unsigned char* cells, unsigned char* abstract);
+
+Word rankD(Database* d, unsigned char* abstract);
+
+void unrankD(Database* d, Word rank, unsigned char* abstract);
+
+int estimateD(Database* d, unsigned char* cells);
+
+int saveD(Database* d, char* file, int w, int h, char* abstract);
+
+int loadD(Database* d, Packing* pk, char* goal, int w, int h, char* file);
+
+int destroyD(Database* d);
+
+#endif
@@ -0,0 +1,685 @@
+/**
+ * Disk.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Bidirectional BFS with delayed duplicate detection.  Nothing is
+ * looked up as it is generated: the neighbors of a level are sorted in
+ * memory RUNBYTES at a time and written out as runs, and the runs are
+ * then merged into the next level, dropping duplicates along with
+ * anything already in the two levels before it.  Every flip is its own
+ * inverse, so the neighbors of level d can only be in levels d - 1, d
+ * and d + 1, and those are the only files the merge has to read.
+ *
+ * Memory use is bounded by the run buffer and the buffers of the files
+ * being merged; everything else is on disk.
+ *
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <string.h>
+#include <unistd.h>
+#include "Disk.h"
+
+// Name of the files created in Disk.dir (for mkstemp())
+#define SCRATCH "pancakeXXXXXX"
+// Number of levels a level array first has room for
+#define MINLEVELS 16
+// Number of keys below which sortKeys() sorts by insertion
+#define MINSORT 16
+
+static int expand(Disk* d, int a, Word* meet);
+static long mergeRuns(Disk* d, FILE** runs, int nRuns, FILE* out,
+        FILE** minus, int nMinus, FILE* other, Word* meet, bool* met);
+static int trace(Disk* d, int a, Word* key, Word* path, int step);
+static int addRun(Disk* d, FILE*** runs, int* nRuns, long count);
+static int pushLevel(Disk* d, int a, FILE* f);
+static FILE* scratch(Disk* d);
+static bool openC(Cursor* c, FILE* f, Word* key, int width);
+static bool readC(Cursor* c);
+static bool seekC(Cursor* c, Word* key);
+static void siftDown(Cursor* in, int* heap, int n, int i);
+static void sortKeys(Word* keys, long count, int width);
+static bool findKey(Word* keys, long count, Word* key, int width);
+static void swapKeys(Word* a, Word* b, int width);
+static int compareKeys(const Word* a, const Word* b, int width);
+
+/**
+ * Function: diskSearch()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * Bidirectional BFS between two configurations, expanding one whole
+ * level of whichever frontier is smaller at every step, as
+ * levelSearch() does.  Each new level is only compared against the
+ * other side's frontier: if the two ends are D flips apart, the
+ * configuration dI flips along a shortest path is on level dI of one
+ * side and level dG = D - dI of the other, so the first meeting comes
+ * as soon as dI + dG reaches D, and not before.
+ *
+ * inputs
+ * ~~~~~~
+ * pk: pointer to Packing of the configurations
+ * w, h: dimensions of the pancake
+ * maxlen: maximum number of flips
+ * dir: directory to keep the levels in
+ * initial, goal: packed INITIAL and GOAL
+ * path: where to store a malloc'd array of the keys on the path,
+ *       pk->width Words each (NULL if there is no path)
+ *
+ * returns: number of flips in the path, -1 if there is none, NOSPACE
+ *          if memory or disk ran out, NOWRITE if no file can be made
+ *          in dir
+ **/
+int diskSearch(Packing* pk, int w, int h, int maxlen, char* dir,
+        Word* initial, Word* goal, Word** path) {
+    Disk d;
+    int width = pk->width;
+    *path = NULL;
+    d.pk = pk;
+    d.width = w;
+    d.height = h;
+    d.nStep = countMoves(w, h);
+    d.dir = dir;
+    d.nBuffer = RUNBYTES / (sizeof(Word) * width);
+    d.buffer = malloc(sizeof(Word) * width * d.nBuffer);
+    Word* root[2] = {initial, goal};
+    int found = (d.buffer == NULL) ? -1 : 0;
+    for (int a = 0; a < 2; a++) {
+        d.level[a] = NULL;
+        d.size[a] = d.depth[a] = 0;
+        d.count[a] = 1;
+        FILE* f = (found == 0) ? scratch(&d) : NULL;
+        if (found != 0) {
+            continue;
+        } else if (f == NULL) {
+            // Nothing has been written yet, so dir itself is at fault
+            found = NOWRITE;
+        } else if (!pushLevel(&d, a, f)) {
+            fclose(f);
+            found = -1;
+        } else if (fwrite(root[a], sizeof(Word), width, f) != width) {
+            found = -1;
+        }
+    }
+    // meet is on level depth[0] of INITIAL's side and depth[1] of GOAL's
+    Word meet[width];
+    if (found == 0 && sameP(initial, goal, width)) {
+        memcpy(meet, initial, sizeof(meet));
+        found = 1;
+    }
+    while (found == 0 && d.depth[0] + d.depth[1] < maxlen) {
+        int a = (d.count[1] < d.count[0]) ? 1 : 0;
+        // A side with nothing left to expand has seen every
+        // configuration it can reach, none of which met the other side
+        if (d.count[a] == 0) {
+            break;
+        }
+        found = expand(&d, a, meet);
+    }
+    int flips = (found == 1) ? d.depth[0] + d.depth[1]
+            : (found == 0) ? -1 : (found == NOWRITE) ? NOWRITE : NOSPACE;
+    if (found == 1) {
+        *path = malloc(sizeof(Word) * width * (flips + 1));
+        if (*path == NULL
+                || !trace(&d, 0, meet, *path + d.depth[0] * width, -1)
+                || !trace(&d, 1, meet, *path + d.depth[0] * width, 1)) {
+            free(*path);
+            *path = NULL;
+            flips = NOSPACE;
+        }
+    }
+    for (int a = 0; a < 2; a++) {
+        for (int i = 0; i < d.depth[a] + 1 && i < d.size[a]; i++) {
+            if (d.level[a][i] != NULL) {
+                fclose(d.level[a][i]);
+            }
+        }
+        free(d.level[a]);
+    }
+    free(d.buffer);
+    return flips;
+}
+
+/**
+ * Function: expand()
+ * ~~~~~~~~~~~~~~~~~~
+ * Writes the next level of side a and makes it the frontier, stopping
+ * early if it meets the other side's frontier.
+ *
+ * inputs
+ * ~~~~~~
+ * d: pointer to Disk
+ * a: side being expanded
+ * meet: where to store the configuration the sides met at
+ *
+ * returns: 1 if the two sides met, 0 if not, -1 if memory or disk ran
+ *          out
+ **/
+static int expand(Disk* d, int a, Word* meet) {
+    int width = d->pk->width;
+    FILE* from = d->level[a][d->depth[a]];
+    FILE** runs = NULL;
+    int nRuns = 0;
+    long fill = 0;
+    int ok = true;
+    Word key[width];
+    rewind(from);
+    // Write the neighbors of every configuration on the frontier
+    while (ok && fread(key, sizeof(Word), width, from) == width) {
+        if (fill + d->nStep > d->nBuffer) {
+            ok = addRun(d, &runs, &nRuns, fill);
+            fill = 0;
+        }
+        getBatch(d->pk, key, d->width, d->height,
+                d->buffer + fill * width, NULL, 0, NULL);
+        fill += d->nStep;
+    }
+    if (ok && fill > 0) {
+        ok = addRun(d, &runs, &nRuns, fill);
+    }
+    ok = ok && !ferror(from);
+    // Merge MAXFANIN runs at a time until the rest can be merged at once
+    while (ok && nRuns > MAXFANIN) {
+        FILE* merged = scratch(d);
+        FILE** group = runs + nRuns - MAXFANIN;
+        ok = merged != NULL && mergeRuns(d, group, MAXFANIN, merged,
+                NULL, 0, NULL, NULL, NULL) >= 0;
+        for (int i = 0; i < MAXFANIN; i++) {
+            fclose(group[i]);
+        }
+        nRuns -= MAXFANIN;
+        if (merged != NULL) {
+            runs[nRuns++] = merged;
+        }
+    }
+    // Neighbors of level d lie on levels d - 1, d and d + 1
+    FILE* minus[2] = {from, NULL};
+    int nMinus = 1;
+    if (d->depth[a] > 0) {
+        minus[nMinus++] = d->level[a][d->depth[a] - 1];
+    }
+    FILE* next = ok ? scratch(d) : NULL;
+    bool met = false;
+    long count = -1;
+    if (next != NULL) {
+        FILE* other = d->level[!a][d->depth[!a]];
+        count = mergeRuns(d, runs, nRuns, next, minus, nMinus, other,
+                meet, &met);
+    }
+    for (int i = 0; i < nRuns; i++) {
+        fclose(runs[i]);
+    }
+    free(runs);
+    if (count < 0 || !pushLevel(d, a, next)) {
+        if (next != NULL) {
+            fclose(next);
+        }
+        return -1;
+    }
+    d->depth[a]++;
+    d->count[a] = count;
+    return met;
+}
+
+/**
+ * Function: mergeRuns()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Merges files of sorted keys into one, keeping a single copy of each
+ * key and dropping those in any of the minus files.  If other is not
+ * NULL, the merge stops at the first key written that is also there.
+ *
+ * inputs
+ * ~~~~~~
+ * d: pointer to Disk
+ * runs: files of sorted keys
+ * nRuns: number of runs (at most MAXFANIN)
+ * out: file to write to
+ * minus: files of sorted keys to leave out
+ * nMinus: number of minus files
+ * other: file of sorted keys to stop at (or NULL)
+ * meet: where to store the key found in other
+ * met: where to store whether one was
+ *
+ * returns: number of keys written, -1 if memory or disk ran out
+ **/
+static long mergeRuns(Disk* d, FILE** runs, int nRuns, FILE* out,
+        FILE** minus, int nMinus, FILE* other, Word* meet, bool* met) {
+    int width = d->pk->width;
+    // Every file being read gets a Cursor and room for one key
+    Word keys[(nRuns + nMinus + 1) * width];
+    Cursor in[nRuns];
+    Cursor skip[nMinus + 1];
+    int heap[nRuns];
+    int nHeap = 0;
+    for (int i = 0; i < nRuns; i++) {
+        if (openC(&in[i], runs[i], keys + i * width, width)) {
+            heap[nHeap++] = i;
+        }
+    }
+    for (int i = nHeap / 2 - 1; i >= 0; i--) {
+        siftDown(in, heap, nHeap, i);
+    }
+    for (int i = 0; i <= nMinus; i++) {
+        FILE* f = (i < nMinus) ? minus[i] : other;
+        if (f != NULL) {
+            openC(&skip[i], f, keys + (nRuns + i) * width, width);
+        } else {
+            skip[i].live = false;
+        }
+    }
+    Word last[width];
+    bool any = false;
+    long count = 0;
+    while (nHeap > 0) {
+        Cursor* top = &in[heap[0]];
+        if (!any || compareKeys(top->key, last, width) != 0) {
+            memcpy(last, top->key, sizeof(last));
+            any = true;
+            bool old = false;
+            for (int i = 0; i < nMinus; i++) {
+                old = seekC(&skip[i], last) || old;
+            }
+            if (!old) {
+                if (fwrite(last, sizeof(Word), width, out) != width) {
+                    return -1;
+                }
+                count++;
+                if (other != NULL && seekC(&skip[nMinus], last)) {
+                    memcpy(meet, last, sizeof(last));
+                    *met = true;
+                    break;
+                }
+            }
+        }
+        if (!readC(top)) {
+            heap[0] = heap[--nHeap];
+        }
+        siftDown(in, heap, nHeap, 0);
+    }
+    for (int i = 0; i < nRuns; i++) {
+        if (ferror(runs[i])) {
+            return -1;
+        }
+    }
+    return (fflush(out) == 0) ? count : -1;
+}
+
+/**
+ * Function: trace()
+ * ~~~~~~~~~~~~~~~~~
+ * Writes the configurations from one on the frontier of side a back to
+ * its root, finding at every step a neighbor on the level below by
+ * reading through it.
+ *
+ * inputs
+ * ~~~~~~
+ * d: pointer to Disk
+ * a: side
+ * key: configuration on level depth[a] of side a
+ * path: where to write it
+ * step: +1 to write the following ones after it, -1 before it
+ *
+ * returns: status
+ **/
+static int trace(Disk* d, int a, Word* key, Word* path, int step) {
+    int width = d->pk->width;
+    Word* cur = path;
+    memcpy(cur, key, sizeof(Word) * width);
+    for (int k = d->depth[a] - 1; k >= 0; k--) {
+        Word* next = cur + step * width;
+        getBatch(d->pk, cur, d->width, d->height, d->buffer, NULL, 0,
+                NULL);
+        sortKeys(d->buffer, d->nStep, width);
+        FILE* f = d->level[a][k];
+        bool found = false;
+        rewind(f);
+        while (!found && fread(next, sizeof(Word), width, f) == width) {
+            found = findKey(d->buffer, d->nStep, next, width);
+        }
+        if (!found) {
+            return false;
+        }
+        cur = next;
+    }
+    return true;
+}
+
+/**
+ * Function: addRun()
+ * ~~~~~~~~~~~~~~~~~~
+ * Sorts the keys in the buffer and writes one copy of each to a new
+ * file at the end of runs.
+ *
+ * inputs
+ * ~~~~~~
+ * d: pointer to Disk
+ * runs: pointer to malloc'd array of runs (or NULL)
+ * nRuns: pointer to number of runs
+ * count: number of keys in d->buffer
+ *
+ * returns: status
+ **/
+static int addRun(Disk* d, FILE*** runs, int* nRuns, long count) {
+    int width = d->pk->width;
+    FILE** more = realloc(*runs, sizeof(FILE*) * (*nRuns + 1));
+    if (more == NULL) {
+        return false;
+    }
+    *runs = more;
+    sortKeys(d->buffer, count, width);
+    FILE* f = scratch(d);
+    if (f == NULL) {
+        return false;
+    }
+    for (long i = 0; i < count; i++) {
+        Word* key = d->buffer + i * width;
+        if (i > 0 && compareKeys(key, key - width, width) == 0) {
+            continue;
+        }
+        if (fwrite(key, sizeof(Word), width, f) != width) {
+            fclose(f);
+            return false;
+        }
+    }
+    if (fflush(f) != 0) {
+        fclose(f);
+        return false;
+    }
+    more[(*nRuns)++] = f;
+    return true;
+}
+
+/**
+ * Function: pushLevel()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Adds the file of a new level to side a (level depth[a] + 1, or 0 for
+ * the root).
+ *
+ * inputs
+ * ~~~~~~
+ * d: pointer to Disk
+ * a: side
+ * f: file of the level
+ *
+ * returns: status
+ **/
+static int pushLevel(Disk* d, int a, FILE* f) {
+    int i = (d->level[a] == NULL) ? 0 : d->depth[a] + 1;
+    if (i == d->size[a]) {
+        int size = (d->size[a] == 0) ? MINLEVELS : 2 * d->size[a];
+        FILE** level = realloc(d->level[a], sizeof(FILE*) * size);
+        if (level == NULL) {
+            return false;
+        }
+        d->level[a] = level;
+        d->size[a] = size;
+    }
+    d->level[a][i] = f;
+    return true;
+}
+
+/**
+ * Function: scratch()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Creates a file in d->dir that is removed as soon as it is closed.
+ *
+ * input
+ * ~~~~~
+ * d: pointer to Disk
+ *
+ * returns: the file, open for reading and writing, NULL on failure
+ **/
+static FILE* scratch(Disk* d) {
+    size_t length = strlen(d->dir) + sizeof(SCRATCH) + 1;
+    char name[length];
+    snprintf(name, length, "%s/%s", d->dir, SCRATCH);
+    int fd = mkstemp(name);
+    if (fd < 0) {
+        return NULL;
+    }
+    unlink(name);
+    FILE* f = fdopen(fd, "w+b");
+    if (f == NULL) {
+        close(fd);
+    }
+    return f;
+}
+
+/**
+ * Function: openC()
+ * ~~~~~~~~~~~~~~~~~
+ * Starts reading a file of sorted keys from the beginning.
+ *
+ * inputs
+ * ~~~~~~
+ * c: pointer to Cursor
+ * f: the file
+ * key: room for one key
+ * width: number of Words in a key
+ *
+ * returns: true if the file has a key
+ **/
+static bool openC(Cursor* c, FILE* f, Word* key, int width) {
+    c->file = f;
+    c->key = key;
+    c->width = width;
+    rewind(f);
+    return readC(c);
+}
+
+/**
+ * Function: readC()
+ * ~~~~~~~~~~~~~~~~~
+ * Reads the next key of a Cursor.
+ *
+ * input
+ * ~~~~~
+ * c: pointer to Cursor
+ *
+ * returns: false if the file has run out
+ **/
+static bool readC(Cursor* c) {
+    c->live = fread(c->key, sizeof(Word), c->width, c->file) == c->width;
+    return c->live;
+}
+
+/**
+ * Function: seekC()
+ * ~~~~~~~~~~~~~~~~~
+ * Moves a Cursor past every key smaller than key.  Keys looked for
+ * must never decrease.
+ *
+ * inputs
+ * ~~~~~~
+ * c: pointer to Cursor
+ * key: key looked for
+ *
+ * returns: true if the file holds key
+ **/
+static bool seekC(Cursor* c, Word* key) {
+    while (c->live && compareKeys(c->key, key, c->width) < 0) {
+        readC(c);
+    }
+    return c->live && compareKeys(c->key, key, c->width) == 0;
+}
+
+/**
+ * Function: siftDown()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Restores the order of a heap of Cursors below position i, smallest
+ * key first.
+ *
+ * inputs
+ * ~~~~~~
+ * in: the Cursors
+ * heap: indices into in
+ * n: number of indices in heap
+ * i: position that may be out of order
+ *
+ * returns: nothing
+ **/
+static void siftDown(Cursor* in, int* heap, int n, int i) {
+    int width = in[0].width;
+    while (2 * i + 1 < n) {
+        int child = 2 * i + 1;
+        if (child + 1 < n && compareKeys(in[heap[child + 1]].key,
+                in[heap[child]].key, width) < 0) {
+            child++;
+        }
+        if (compareKeys(in[heap[i]].key, in[heap[child]].key, width) <= 0) {
+            return;
+        }
+        int swap = heap[i];
+        heap[i] = heap[child];
+        heap[child] = swap;
+        i = child;
+    }
+}
+
+/**
+ * Function: sortKeys()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Sorts keys in place by quicksort, recursing into the smaller part of
+ * every partition so that the stack stays O(log count), and finishing
+ * short stretches by insertion.  qsort() would need the width in a
+ * global, since its comparison function only gets the two keys.
+ *
+ * inputs
+ * ~~~~~~
+ * keys: the keys
+ * count: number of keys
+ * width: number of Words in a key
+ *
+ * returns: nothing
+ **/
+static void sortKeys(Word* keys, long count, int width) {
+    Word pivot[width];
+    while (count > MINSORT) {
+        // Median of the first, middle and last keys, which also leaves
+        // a key no larger than it first and none smaller last
+        Word* lo = keys;
+        Word* mid = keys + (count - 1) / 2 * width;
+        Word* hi = keys + (count - 1) * width;
+        if (compareKeys(mid, lo, width) < 0) {
+            swapKeys(mid, lo, width);
+        }
+        if (compareKeys(hi, mid, width) < 0) {
+            swapKeys(hi, mid, width);
+            if (compareKeys(mid, lo, width) < 0) {
+                swapKeys(mid, lo, width);
+            }
+        }
+        memcpy(pivot, mid, sizeof(pivot));
+        long i = 0;
+        long j = count - 1;
+        while (true) {
+            while (compareKeys(keys + i * width, pivot, width) < 0) {
+                i++;
+            }
+            while (compareKeys(pivot, keys + j * width, width) < 0) {
+                j--;
+            }
+            if (i >= j) {
+                break;
+            }
+            swapKeys(keys + i * width, keys + j * width, width);
+            i++;
+            j--;
+        }
+        // Keys 0 to j are no larger than pivot, the rest no smaller
+        long left = j + 1;
+        if (left < count - left) {
+            sortKeys(keys, left, width);
+            keys += left * width;
+            count -= left;
+        } else {
+            sortKeys(keys + left * width, count - left, width);
+            count = left;
+        }
+    }
+    for (long i = 1; i < count; i++) {
+        memcpy(pivot, keys + i * width, sizeof(pivot));
+        long j = i;
+        while (j > 0 && compareKeys(keys + (j - 1) * width, pivot,
+                width) > 0) {
+            memcpy(keys + j * width, keys + (j - 1) * width,
+                    sizeof(pivot));
+            j--;
+        }
+        memcpy(keys + j * width, pivot, sizeof(pivot));
+    }
+}
+
+/**
+ * Function: findKey()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Looks for a key among sorted keys by binary search.
+ *
+ * inputs
+ * ~~~~~~
+ * keys: the sorted keys
+ * count: number of keys
+ * key: key looked for
+ * width: number of Words in a key
+ *
+ * returns: true if key is there
+ **/
+static bool findKey(Word* keys, long count, Word* key, int width) {
+    long lo = 0;
+    long hi = count;
+    while (lo < hi) {
+        long mid = lo + (hi - lo) / 2;
+        int order = compareKeys(keys + mid * width, key, width);
+        if (order == 0) {
+            return true;
+        } else if (order < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return false;
+}
+
+/**
+ * Function: swapKeys()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Exchanges two keys.
+ *
+ * inputs
+ * ~~~~~~
+ * a, b: pointers to the keys
+ * width: number of Words in a key
+ *
+ * returns: nothing
+ **/
+static void swapKeys(Word* a, Word* b, int width) {
+    for (int i = 0; i < width; i++) {
+        Word swap = a[i];
+        a[i] = b[i];
+        b[i] = swap;
+    }
+}
+
+/**
+ * Function: compareKeys()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Orders keys, first Word first.
+ *
+ * inputs
+ * ~~~~~~
+ * a, b: pointers to the keys
+ * width: number of Words in a key
+ *
+ * returns: negative, zero or positive as a is below, equal to or above b
+ **/
+static int compareKeys(const Word* a, const Word* b, int width) {
+    for (int i = 0; i < width; i++) {
+        if (a[i] != b[i]) {
+            return (a[i] < b[i]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * Disk.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for bidirectional BFS with its levels kept in files, for
+ * searches too large for memory.
+ *
+ **/
+#ifndef DISK_H
+#define DISK_H
+
+#include <stdio.h>
+#include "Flip.h"
+
+// Bytes of packed keys sorted in memory at a time
+#define RUNBYTES ((size_t) 64 << 20)
+// Largest number of sorted runs merged at once
+#define MAXFANIN 64
+
+// Results of diskSearch() when it fails
+#define NOSPACE (-2)
+#define NOWRITE (-3)
+
+/**
+ * Struct: Disk
+ * ~~~~~~~~~~~~
+ * State of a bidirectional BFS whose levels are files of packed keys in
+ * sorted order.  The files are unlinked as soon as they are created, so
+ * they disappear once closed, however the search ends.
+ *
+ * Side 0 grows from INITIAL and side 1 from GOAL.
+ *
+ * members
+ * ~~~~~~~
+ * Packing* pk:     packing of configurations
+ * int width, height:   dimensions of the pancake
+ * int nStep:       number of flips
+ * char* dir:       directory the files are created in
+ * Word* buffer:    keys being sorted into a run
+ * long nBuffer:    number of keys buffer has room for
+ * FILE** level[]:  every level of each side
+ * int size[]:      number of levels each level array has room for
+ * int depth[]:     number of levels each side has expanded
+ * long count[]:    number of configurations on the frontier of each side
+ **/
+typedef struct Disk {
+    Packing* pk;
+    int width;
+    int height;
+    int nStep;
+    char* dir;
+    Word* buffer;
+    long nBuffer;
+    FILE** level[2];
+    int size[2];
+    int depth[2];
+    long count[2];
+} Disk;
+
+/**
+ * Struct: Cursor
+ * ~~~~~~~~~~~~~~
+ * Position in a file of sorted keys being read from start to end.
+ *
+ * members
+ * ~~~~~~~
+ * FILE* file:  the file
+ * Word* key:   key last read
+ * int width:   number of Words in a key
+ * bool live:   false once the file has run out
+ **/
+typedef struct Cursor {
+    FILE* file;
+    Word* key;
+    int width;
+    bool live;
+} Cursor;
+
+/* See Disk.c for full explanations */
+int diskSearch(Packing* pk, int w, int h, int maxlen, char* dir,
+        Word* initial, Word* goal, Word** path);
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ * Flip.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Implementation of the two-dimensional pancake flips that connect 
+ * configurations.  Shared by every search in pancake.
+ *
+ **/
+#include "Flip.h"
+
+/**
+ * Function: countMoves()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * Number of configurations reachable from any configuration by a 
+ * single flip (flips of a single cell are excluded).
+ *
+ * input
+ * ~~~~~
+ * w: width of the pancake
+ * h: height of the pancake
+ *
+ * returns: 2 * (w - 1) * (h - 1) + (w - 1) + (h - 1)
+ **/
+int countMoves(int w, int h) {
+    return 2 * (w - 1) * (h - 1) + (w - 1) + (h - 1);
+}
+
+/**
+ * Function: listMoves()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Lists every flip in the same order in which getBatch() generates 
+ * neighbors, so that the i-th neighbor in a batch is produced by 
+ * moves[i].
+ *
+ * input
+ * ~~~~~
+ * w: width of the pancake
+ * h: height of the pancake
+ * moves: room for countMoves(w, h) Moves
+ *
+ * returns: number of Moves listed
+ **/
+int listMoves(int w, int h, Move* moves) {
+    int n = 0;
+    for (int i = 0; i < w; i++) {
+        for (int j = 0; j < h; j++) {
+            if (i != 0) {
+                moves[n].fw = i + 1;
+                moves[n].fh = j + 1;
+                moves[n++].v = 1;
+            }
+            if (j != 0) {
+                moves[n].fw = i + 1;
+                moves[n].fh = j + 1;
+                moves[n++].v = 0;
+            }
+        }
+    }
+    return n;
+}
+
+/**
+ * Function: flipPancake()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Given an unpacked configuration, creates a horizontal or vertical 
+ * "flip" permutation of it along a specified width and height.
+ *
+ * input
+ * ~~~~~
+ * old: symbol indices of configuration to permute
+ * new: array of w * h symbol indices in which to store the result
+ * w: width of old
+ * h: height of old
+ * fw: width of the flip, starting from upper left
+ * fh: height of the flip, starting from upper left
+ * v: 1 if vertical flip, 0 if horizontal flip
+ *
+ * returns: nothing
+ **/
+void flipPancake(unsigned char* old, unsigned char* new, int w, int h, 
+        int fw, int fh, int v) {
+    for (int i = 0; i < w * fh; i++) {
+        // Permuting of characters only necessary if we are 
+        // in a column that is permuted
+        if (i % w < fw) {
+            // Permute characters depending on vertical/horizontal flip
+            if (v) {
+               new[(i / w) * w + fw - 1 - (i % w)] = old[i];
+            } else {
+               new[(fh - 1 - (i / w)) * w + (i % w)] = old[i]; 
+            }
+        } else {
+            new[i] = old[i];
+        }
+    }
+    // Copy characters on rows that do not require permuting 
+    // directly
+    for (int i = w * fh; i < w * h; i++) {
+        new[i] = old[i];
+    }
+}
+
+
+/**
+ * Function: getBatch()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Given a packed configuration, its width, and its height, getBatch() 
+ * writes the packed keys of the permutations reachable from a single 
+ * flip, one after another, into batch.  Nothing is allocated, so the 
+ * same batch can be reused for every configuration expanded.
+ *
+ * Given Zobrist codes and the hash of config, the hash of every key is 
+ * also written into hashes, updated from that of config over just the 
+ * flipped block.
+ *
+ * 2 * (w - 1) * (h - 1) + (w - 1) + (h - 1) configurations are written.
+ *
+ * input
+ * ~~~~~
+ * pk: pointer to Packing used for config
+ * config: packed configuration to be permuted
+ * w: width of config
+ * h: height of config
+ * batch: room for that many keys of pk->width Words each
+ * z: Zobrist codes (NULL if hashes are not wanted)
+ * hash: Zobrist hash of config
+ * hashes: room for that many hashes
+ *
+ * returns: batch
+ **/
+Word* getBatch(Packing* pk, Word* config, int w, int h, Word* batch, 
+        Zobrist* z, unsigned long hash, unsigned long* hashes) {
+    // Pointer to current permutation (updated on each iteration)
+    Word* pancake = batch;
+    unsigned char old[w * h];
+    unsigned char new[w * h];
+    unpackP(pk, config, old);
+    for (int i = 0; i < w; i++) {
+        for (int j = 0; j < h; j++) {
+            // Don't create a permutation with a flip height of 
+            // 1 and flip width of 1... it's invariant
+            if (i != 0) {
+                flipPancake(old, new, w, h, i + 1, j + 1, 1);
+                packP(pk, new, pancake);
+                pancake += pk->width;
+                if (z != NULL) {
+                    *hashes++ = flipZ(z, hash, old, new, w, i + 1, j + 1);
+                }
+            }
+            if (j != 0) {
+                flipPancake(old, new, w, h, i + 1, j + 1, 0);
+                packP(pk, new, pancake);
+                pancake += pk->width;
+                if (z != NULL) {
+                    *hashes++ = flipZ(z, hash, old, new, w, i + 1, j + 1);
+                }
+            }
+        }
+    }
+    return batch;
+}
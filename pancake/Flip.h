@@ -0,0 +1,47 @@
+/**
+ * Flip.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for the pancake flip move set.
+ *
+ **/
+#ifndef FLIP_H
+#define FLIP_H
+
+#include "Packing.h"
+#include "Zobrist.h"
+
+/**
+ * Struct: Move
+ * ~~~~~~~~~~~~
+ * A single flip of the fw x fh block in the upper left corner.
+ *
+ * members
+ * ~~~~~~~
+ * unsigned char fw:    width of the flip
+ * unsigned char fh:    height of the flip
+ * unsigned char v:     1 if vertical flip, 0 if horizontal flip
+ **/
+typedef struct Move {
+    unsigned char fw;
+    unsigned char fh;
+    unsigned char v;
+} Move;
+
+/* See Flip.c for full explanations */
+int countMoves(int w, int h);
+
+int listMoves(int w, int h, Move* moves);
+
+void flipPancake(unsigned char* old, unsigned char* new, int w, int h, 
+        int fw, int fh, int v);
+
+Word* getBatch(Packing* pk, Word* config, int w, int h, Word* batch, 
+        Zobrist* z, unsigned long hash, unsigned long* hashes);
+
+#endif
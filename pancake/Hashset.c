@@ -0,0 +1,243 @@
+/**
+ * Hashset.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Lock-free insert-if-absent over a fixed number of slots.  The tag of
+ * a slot goes from EMPTY to BUSY by compare-and-swap, which gives one
+ * thread the right to write the hash, key and payload; storing the
+ * final tag (the hash with READY set) then publishes them.  A thread
+ * probing past a BUSY slot waits for it to be published before
+ * comparing keys, which only takes as long as copying one key.  Slots
+ * are never emptied, so a key is found in the same slot by everyone.
+ *
+ * The atomics are the GCC builtins, so that the code stays C99.
+ *
+ **/
+#include <string.h>
+#include "Hashset.h"
+#include "Hashtable.h"
+
+// Tags of slots: never used, being written, and published (with the
+// hash in the other bits)
+#define EMPTY 0UL
+#define BUSY 1UL
+#define READY 2UL
+// Refuse insertions once count / size would exceed LOADNUM / LOADDEN
+#define LOADNUM 3
+#define LOADDEN 4
+// Smallest set ever allocated
+#define MINBITS 4
+
+static int bitsFor(long size);
+static unsigned long tagOf(unsigned long h);
+
+/**
+ * Function: createT()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Creates an empty set with room for at least size keys.
+ *
+ * inputs
+ * ~~~~~~
+ * set: pointer to Hashset struct
+ * size: number of keys it should take
+ * width: number of Words in every key
+ *
+ * returns: status
+ **/
+int createT(Hashset* set, long size, int width) {
+    set->bits = bitsFor(size);
+    set->size = 1L << set->bits;
+    set->limit = set->size * LOADNUM / LOADDEN;
+    set->count = 0;
+    set->width = width;
+    // Only the tags need to start out cleared
+    set->tag = calloc(set->size, sizeof(unsigned long));
+    set->hash = malloc(sizeof(unsigned long) * set->size);
+    set->key = malloc(sizeof(Word) * width * set->size);
+    set->value = malloc(sizeof(long) * set->size);
+    if (set->tag == NULL || set->hash == NULL || set->key == NULL
+            || set->value == NULL) {
+        destroyT(set);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Function: insertT()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Adds a key unless it is already in the set.  Safe to call from any
+ * number of threads at once, as long as no thread calls nextT() or
+ * destroyT() meanwhile.  When two threads add the same key, exactly
+ * one of them gets ADDED.
+ *
+ * inputs
+ * ~~~~~~
+ * set: pointer to Hashset struct
+ * key: packed key (copied)
+ * h: hash of key
+ * value: payload stored if the key is added
+ *
+ * returns: ADDED, PRESENT if the key was already in the set, FULL if
+ *          it was not but the set is too full to take it
+ **/
+int insertT(Hashset* set, Word* key, unsigned long h, long value) {
+    unsigned long want = tagOf(h);
+    long mask = set->size - 1;
+    // Slots are picked as in a Hashtable
+    long i = (long) (SLOTMIX(h) >> (64 - set->bits));
+    for (;;) {
+        unsigned long tag = __atomic_load_n(&set->tag[i], __ATOMIC_ACQUIRE);
+        if (tag == EMPTY) {
+            // Reserve room before claiming, so that the set never fills
+            // up and probing always ends at an EMPTY slot
+            if (__atomic_add_fetch(&set->count, 1, __ATOMIC_RELAXED)
+                    > set->limit) {
+                __atomic_sub_fetch(&set->count, 1, __ATOMIC_RELAXED);
+                return FULL;
+            }
+            unsigned long expected = EMPTY;
+            if (__atomic_compare_exchange_n(&set->tag[i], &expected, BUSY,
+                    false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                set->hash[i] = h;
+                memcpy(keyT(set, i), key, sizeof(Word) * set->width);
+                set->value[i] = value;
+                __atomic_store_n(&set->tag[i], want, __ATOMIC_RELEASE);
+                return ADDED;
+            }
+            // Another thread claimed the slot first; look at what it
+            // writes there
+            __atomic_sub_fetch(&set->count, 1, __ATOMIC_RELAXED);
+            tag = expected;
+        }
+        while (tag == BUSY) {
+            tag = __atomic_load_n(&set->tag[i], __ATOMIC_ACQUIRE);
+        }
+        if (tag == want && sameP(keyT(set, i), key, set->width)) {
+            return PRESENT;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+/**
+ * Function: nextT()
+ * ~~~~~~~~~~~~~~~~~
+ * Iterates over the slots that hold a key, in slot order.  Only for use
+ * once every insertT() has returned.
+ *
+ * inputs
+ * ~~~~~~
+ * set: pointer to Hashset struct
+ * cursor: position to resume from (set to 0 to start)
+ *
+ * returns: index of the next slot holding a key (see keyT(), hashT()
+ *          and valueT()), -1 once there are none left
+ **/
+long nextT(Hashset* set, long* cursor) {
+    while (*cursor < set->size) {
+        long i = (*cursor)++;
+        if (set->tag[i] != EMPTY) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Function: clearT()
+ * ~~~~~~~~~~~~~~~~~~
+ * Empties a set, keeping its slots.  Only for use once every insertT()
+ * has returned.
+ *
+ * input
+ * ~~~~~
+ * set: pointer to Hashset struct
+ *
+ * returns: nothing
+ **/
+void clearT(Hashset* set) {
+    memset(set->tag, 0, sizeof(unsigned long) * set->size);
+    set->count = 0;
+}
+
+/**
+ * Function: bytesT()
+ * ~~~~~~~~~~~~~~~~~~
+ * Memory taken by a set created with room for a given number of keys.
+ *
+ * inputs
+ * ~~~~~~
+ * size: number of keys the set should take
+ * width: number of Words in every key
+ *
+ * returns: bytes allocated by createT()
+ **/
+long bytesT(long size, int width) {
+    return (1L << bitsFor(size)) * (2 * sizeof(unsigned long) 
+            + sizeof(Word) * width + sizeof(long));
+}
+
+/**
+ * Function: destroyT()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Frees a set.
+ *
+ * input
+ * ~~~~~
+ * set: pointer to Hashset struct
+ *
+ * returns: status
+ **/
+int destroyT(Hashset* set) {
+    free(set->tag);
+    free(set->hash);
+    free(set->key);
+    free(set->value);
+    set->tag = set->hash = NULL;
+    set->key = NULL;
+    set->value = NULL;
+    set->size = set->count = 0;
+    return true;
+}
+
+/**
+ * Function: bitsFor()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Number of bits of the slot index of a set with room for a given 
+ * number of keys.
+ *
+ * input
+ * ~~~~~
+ * size: number of keys the set should take
+ *
+ * returns: log2 of the number of slots
+ **/
+static int bitsFor(long size) {
+    int bits = MINBITS;
+    while ((1L << bits) * LOADNUM / LOADDEN < size) {
+        bits++;
+    }
+    return bits;
+}
+
+/**
+ * Function: tagOf()
+ * ~~~~~~~~~~~~~~~~~
+ * Published tag of a slot holding a key with a given hash: never EMPTY
+ * or BUSY, and the same for equal keys.
+ *
+ * input
+ * ~~~~~
+ * h: hash of the key
+ *
+ * returns: the tag
+ **/
+static unsigned long tagOf(unsigned long h) {
+    return h | READY;
+}
@@ -0,0 +1,76 @@
+/**
+ * Hashset.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for a fixed-size hash set that several threads can add
+ * to at once.
+ *
+ **/
+#ifndef HASHSET_H
+#define HASHSET_H
+
+#include "Packing.h"
+
+// Results of insertT()
+#define ADDED 1
+#define PRESENT 0
+#define FULL (-1)
+
+/**
+ * Struct: Hashset
+ * ~~~~~~~~~~~~~~~
+ * An open-addressed set of keys with linear probing, like a Hashtable,
+ * except that it never grows: an insertion that would take it past
+ * three quarters full is refused instead.  Each slot has a tag that a
+ * thread claims with a compare-and-swap before writing the key into
+ * the slot, and then publishes; no locks are taken.  Every field is an
+ * array of its own, as in Nodes.
+ *
+ * members
+ * ~~~~~~~
+ * unsigned long* tag:  state of each slot (see Hashset.c)
+ * unsigned long* hash: hash of the key in each slot
+ * Word* key:           keys, width Words each
+ * long* value:         payload of each key
+ * long size:           number of slots (a power of two)
+ * long limit:          most keys the set takes
+ * long count:          number of keys (updated atomically)
+ * int bits:            log2(size)
+ * int width:           number of Words in every key
+ **/
+typedef struct Hashset {
+    unsigned long* tag;
+    unsigned long* hash;
+    Word* key;
+    long* value;
+    long size;
+    long limit;
+    long count;
+    int bits;
+    int width;
+} Hashset;
+
+// Fields of slot i, once nextT() has returned it
+#define keyT(set, i)    ((set)->key + (i) * (set)->width)
+#define hashT(set, i)   ((set)->hash[i])
+#define valueT(set, i)  ((set)->value[i])
+
+/* See Hashset.c for full explanations */
+int createT(Hashset* set, long size, int width);
+
+int insertT(Hashset* set, Word* key, unsigned long h, long value);
+
+long nextT(Hashset* set, long* cursor);
+
+void clearT(Hashset* set);
+
+long bytesT(long size, int width);
+
+int destroyT(Hashset* set);
+
+#endif
@@ -7,33 +7,66 @@
  * Addison Hu
  * addison.hu@yale.edu
  *
- * Implementation of a hashtable backed by linked lists.
+ * Implementation of an open-addressed hashtable with linear probing.
  *
  **/
 #include <string.h>
 #include "Hashtable.h"
 
-static long hash(char* key, long size);
+// Grow the table once count / size exceeds LOADNUM / LOADDEN
+#define LOADNUM 3
+#define LOADDEN 4
+// Smallest table ever allocated
+#define MINBITS 4
+// Constants of hashH(), from wyhash
+#define SEED 0xA0761D6478BD642FUL
+#define MIXA 0xE7037ED1A0B428DBUL
+#define MIXB 0x8EBC6AF09C88C6E3UL
+#define MIXC 0x589965CC75374CC3UL
+
+// 128-bit products (a GCC extension)
+__extension__ typedef unsigned __int128 Wide;
+
+static unsigned long mix(unsigned long a, unsigned long b);
+static unsigned long hashKey(Table* t, Word* key);
+static long findSlot(Table* t, Word* key, unsigned long h);
+static int growH(Table* t);
 
 /**
  * Function: createH()
  * ~~~~~~~~~~~~~~~~~~~
- * Creates a table with size chains.
+ * Creates a table with room for at least size entries.  The table grows
+ * on its own, so size is only a hint.
  *
  * inputs
  * ~~~~~~
  * dict: pointer to Hashtable struct
- * size: number of buckets to include in hashtable
+ * size: expected number of entries
+ * width: number of Words in every key
+ * z: Zobrist codes to hash keys with (NULL to hash their Words)
  *
  * returns: status
  **/
-int createH(Hashtable* dict, long size) {
-    dict->size = size;
-    dict->entry = malloc(dict->size * sizeof(List));
-    memset(dict->entry, 0, sizeof(*(dict->entry)));
-    for (int i = 0; i < dict->size; i++) {
-        createL(&dict->entry[i]);
+int createH(Hashtable* dict, long size, int width, Zobrist* z) {
+    Table* t;
+    t = malloc(sizeof(Table));
+    if (t == NULL) {
+        return false;
     }
+    t->bits = MINBITS;
+    while ((1L << t->bits) * LOADNUM / LOADDEN < size) {
+        t->bits++;
+    }
+    t->size = 1L << t->bits;
+    t->count = 0;
+    t->width = width;
+    t->z = z;
+    t->entry = calloc(t->size, sizeof(Slot));
+    if (t->entry == NULL) {
+        free(t);
+        return false;
+    }
+    dict->table = t;
     return true;
 }
 
@@ -47,41 +80,108 @@ int createH(Hashtable* dict, long size) {
  * ~~~~~
  * dict: Hashtable struct
  * key:  hash key
- * triple: payload to be stored
+ * value: payload to be stored
  *
  * returns: true if successfuly added, false if there already exists 
- *          entry with the same key.
+ *          entry with the same key, NOROOM if the table could not grow.
  **/
-int addH(Hashtable dict, char* key, Triple* triple) {
-    long index = hash(key, dict.size);
-    if (retrieveL(dict.entry[index], key) == NULL) {
-        appendL(dict.entry[index], triple);
-        return true;
-    } else {
+int addH(Hashtable dict, Word* key, long value) {
+    return addHashH(dict, key, hashKey(dict.table, key), value);
+}
+
+/**
+ * Function: addHashH()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Same as addH(), for a key whose hash is already known.
+ *
+ * input
+ * ~~~~~
+ * dict: Hashtable struct
+ * key:  hash key
+ * h: hash of key (as computed by the Hashtable)
+ * value: payload to be stored
+ *
+ * returns: true if successfuly added, false if there already exists
+ *          entry with the same key, NOROOM if the table could not grow.
+ **/
+int addHashH(Hashtable dict, Word* key, unsigned long h, long value) {
+    Table* t = dict.table;
+    long index = findSlot(t, key, h);
+    if (t->entry[index].key != NULL) {
         return false;
     }
+    // Make room first so that the slot we fill is in the final table
+    if ((t->count + 1) * LOADDEN > t->size * LOADNUM) {
+        if (!growH(t)) {
+            return NOROOM;
+        }
+        index = findSlot(t, key, h);
+    }
+    t->entry[index].hash = h;
+    t->entry[index].key = key;
+    t->entry[index].value = value;
+    t->count++;
+    return true;
+}
+
+/**
+ * Function: reserveH()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Grows the table ahead of time so that count more entries can be 
+ * added without growing it.  Adding many keys in the order of their 
+ * hashes to a table that is too small for them probes further and 
+ * further past their slots, which this avoids.
+ *
+ * input
+ * ~~~~~
+ * dict: Hashtable struct
+ * count: number of entries about to be added
+ *
+ * returns: status
+ **/
+int reserveH(Hashtable dict, long count) {
+    Table* t = dict.table;
+    while ((t->count + count) * LOADDEN > t->size * LOADNUM) {
+        if (!growH(t)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 /**
  * Function: retrieveH()
  * ~~~~~~~~~~~~~~~~~~~~~
- * Retrieves the pointer to a triple struct associated with a 
- * given key.  
+ * Retrieves the payload associated with a given key.
+ *
+ * input
+ * ~~~~~
+ * dict: Hashtable struct
+ * key: hash key
  *
- * Note that this calls the retrieveL() function implemented in 
- * LinkedList.c, which guarantees that if there is no entry 
- * associated with the given key, NULL is returned.
+ * returns: payload if entry is present, MISSING otherwise
+ **/
+long retrieveH(Hashtable dict, Word* key) {
+    return retrieveHashH(dict, key, hashKey(dict.table, key));
+}
+
+/**
+ * Function: retrieveHashH()
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Same as retrieveH(), for a key whose hash is already known.
  *
  * input
  * ~~~~~
  * dict: Hashtable struct
  * key: hash key
+ * h: hash of key (as computed by the Hashtable)
  *
- * returns: pointer to triple struct if entry is present, NULL otherwise
+ * returns: payload if entry is present, MISSING otherwise
  **/
-Triple* retrieveH(Hashtable dict, char* key) {
-    long index = hash(key, dict.size);
-    return retrieveL(dict.entry[index], key);
+long retrieveHashH(Hashtable dict, Word* key, unsigned long h) {
+    Table* t = dict.table;
+    Slot* slot = &t->entry[findSlot(t, key, h)];
+    return (slot->key != NULL) ? slot->value : MISSING;
 }
 
 /**
@@ -90,7 +190,8 @@ Triple* retrieveH(Hashtable dict, char* key) {
  * Removes an entry from the hashtable.  Does nothing if the entry 
  * does not exist.  
  *
- * See implementation of removeL() in LinkedList.c.
+ * Rather than leaving a tombstone, later entries of the same probe
+ * run are shifted back so that every run stays contiguous.
  *
  * input
  * ~~~~~
@@ -99,16 +200,106 @@ Triple* retrieveH(Hashtable dict, char* key) {
  *
  * returns: staus
  **/
-int removeH(Hashtable dict, char* key) {
-    long index = hash(key, dict.size);
-    removeL(dict.entry[index], key);
+int removeH(Hashtable dict, Word* key) {
+    return removeHashH(dict, key, hashKey(dict.table, key));
+}
+
+/**
+ * Function: removeHashH()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Same as removeH(), for a key whose hash is already known.
+ *
+ * input
+ * ~~~~~
+ * dict: Hashtable struct
+ * key: hash key
+ * h: hash of key (as computed by the Hashtable)
+ *
+ * returns: status
+ **/
+int removeHashH(Hashtable dict, Word* key, unsigned long h) {
+    Table* t = dict.table;
+    long mask = t->size - 1;
+    long hole = findSlot(t, key, h);
+    if (t->entry[hole].key == NULL) {
+        return true;
+    }
+    for (long i = (hole + 1) & mask; t->entry[i].key != NULL;
+            i = (i + 1) & mask) {
+        long home = SLOTMIX(t->entry[i].hash) 
+                >> (sizeof(unsigned long) * 8 - t->bits);
+        // Entry at i may move into the hole only if its home slot does
+        // not lie (cyclically) strictly between the hole and i
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            t->entry[hole] = t->entry[i];
+            hole = i;
+        }
+    }
+    memset(&t->entry[hole], 0, sizeof(Slot));
+    t->count--;
     return true;
 }
 
+/**
+ * Function: nextH()
+ * ~~~~~~~~~~~~~~~~~
+ * Walks through the entries of the hashtable in slot order.  Adding or 
+ * removing entries during the walk may skip or repeat some.
+ *
+ * inputs
+ * ~~~~~~
+ * dict: Hashtable struct
+ * cursor: slot to look from (0 to start), moved past the entry returned
+ *
+ * returns: payload of the next entry, MISSING when there are no more
+ **/
+long nextH(Hashtable dict, long* cursor) {
+    Table* t = dict.table;
+    while (*cursor < t->size) {
+        Slot* slot = &t->entry[(*cursor)++];
+        if (slot->key != NULL) {
+            return slot->value;
+        }
+    }
+    return MISSING;
+}
+
+/**
+ * Function: probesH()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Counts how far every entry is from the slot its hash selects, which 
+ * is how many other entries a lookup of it has to pass.
+ *
+ * inputs
+ * ~~~~~~
+ * dict: Hashtable struct
+ * histogram: array of nBins counts to fill (the last also counts every 
+ *            longer distance)
+ * nBins: number of counts
+ *
+ * returns: nothing
+ **/
+void probesH(Hashtable dict, long* histogram, int nBins) {
+    Table* t = dict.table;
+    long mask = t->size - 1;
+    for (int i = 0; i < nBins; i++) {
+        histogram[i] = 0;
+    }
+    for (long i = 0; i < t->size; i++) {
+        if (t->entry[i].key != NULL) {
+            long home = SLOTMIX(t->entry[i].hash) 
+                    >> (sizeof(unsigned long) * 8 - t->bits);
+            long distance = (i - home) & mask;
+            histogram[(distance < nBins) ? distance : nBins - 1]++;
+        }
+    }
+}
+
 /** 
  * Function: destroyH()
  * ~~~~~~~~~~~~~~~~~~~~
- * Frees all memory associated with the hashtable.
+ * Frees all memory associated with the hashtable.  Keys belong to the
+ * caller and are left alone.
  *
  * input
  * ~~~~~
@@ -117,36 +308,133 @@ int removeH(Hashtable dict, char* key) {
  * returns: status
  **/
 int destroyH(Hashtable dict) {
-    for (int i = 0; i < dict.size; i++) {
-        destroyL(dict.entry[i]);
-    }
-    free(dict.entry);
+    Table* t = dict.table;
+    free(t->entry);
+    free(t);
     return true;
 }
 
 /**
- * Function: hash()
- * ~~~~~~~~~~~~~~~~
- * Hash function, written by Stanley C. Eisenstat<stanley.eisenstat@yale.edu>
+ * Function: findSlot()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Linearly probes for key, starting from the slot selected by the top
+ * bits of its hash.  Keys are only compared when the cached hashes match.
  *
  * input
  * ~~~~~
+ * t: pointer to Table
  * key: hash key
- * size: size of hashtable
+ * h: hash(key)
  *
- * returns: hash value
+ * returns: index of the slot holding key, or of the empty slot that
+ *          ends its probe run
  **/
-static long hash(char* key, long size) {
-    unsigned long sum;
-    int shift;
-    const unsigned long prime = 3141592653589793239L;
+static long findSlot(Table* t, Word* key, unsigned long h) {
+    long mask = t->size - 1;
+    long i = SLOTMIX(h) >> (sizeof(unsigned long) * 8 - t->bits);
+    while (t->entry[i].key != NULL) {
+        if (t->entry[i].hash == h && sameP(key, t->entry[i].key, t->width)) {
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+    return i;
+}
 
-    for (sum = 0, shift = 0; *key; key++) {
-        sum ^= *key<<shift;
-        shift += 7;
-        if (shift >= 57) {
-            shift -= 57;
+/**
+ * Function: growH()
+ * ~~~~~~~~~~~~~~~~~
+ * Doubles the number of slots and reinserts every entry using its cached
+ * hash.
+ *
+ * input
+ * ~~~~~
+ * t: pointer to Table
+ *
+ * returns: status
+ **/
+static int growH(Table* t) {
+    Slot* old = t->entry;
+    long oldSize = t->size;
+    Slot* entry = calloc(2 * oldSize, sizeof(Slot));
+    if (entry == NULL) {
+        return false;
+    }
+    t->entry = entry;
+    t->size = 2 * oldSize;
+    t->bits++;
+    long mask = t->size - 1;
+    for (long j = 0; j < oldSize; j++) {
+        if (old[j].key != NULL) {
+            long i = SLOTMIX(old[j].hash) 
+                    >> (sizeof(unsigned long) * 8 - t->bits);
+            while (entry[i].key != NULL) {
+                i = (i + 1) & mask;
+            }
+            entry[i] = old[j];
         }
     }
-    return ((prime * sum) % size);
+    free(old);
+    return true;
+}
+
+/**
+ * Function: hashKey()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Hash of a key as used by a Table: its Zobrist hash if the Table has
+ * codes, hashH() of its Words otherwise.
+ *
+ * input
+ * ~~~~~
+ * t: pointer to Table
+ * key: packed key
+ *
+ * returns: hash value
+ **/
+static unsigned long hashKey(Table* t, Word* key) {
+    return (t->z != NULL) ? keyZ(t->z, key) : hashH(key, t->width);
+}
+
+/**
+ * Function: hashH()
+ * ~~~~~~~~~~~~~~~~~
+ * Hash function for packed keys, a Word per step in the manner of 
+ * wyhash: each Word is folded in by a full 64 x 64 -> 128-bit multiply 
+ * whose halves are combined, so every bit of the key reaches every bit 
+ * of the result after one step.  Keys of one board all have the same 
+ * width and differ in a few cells, which a byte-at-a-time hash with 
+ * shifts spreads over too few bits.
+ *
+ * Every bit of the result is as well mixed as any other, so SLOTMIX() 
+ * changes nothing for it.
+ *
+ * inputs
+ * ~~~~~~
+ * key: packed key
+ * width: number of Words in key
+ *
+ * returns: hash value
+ **/
+unsigned long hashH(Word* key, int width) {
+    unsigned long h = SEED ^ (unsigned long) width;
+    for (int i = 0; i < width; i++) {
+        h = mix(key[i] ^ MIXA, h ^ MIXB);
+    }
+    return mix(h ^ MIXA, MIXC);
+}
+
+/**
+ * Function: mix()
+ * ~~~~~~~~~~~~~~~
+ * Multiplies two Words into 128 bits and folds the halves together.
+ *
+ * inputs
+ * ~~~~~~
+ * a, b: Words to multiply
+ *
+ * returns: high half xor low half
+ **/
+static unsigned long mix(unsigned long a, unsigned long b) {
+    Wide product = (Wide) a * b;
+    return (unsigned long) (product >> 64) ^ (unsigned long) product;
 }
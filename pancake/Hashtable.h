@@ -10,33 +10,104 @@
  * Header file for Hashtable implementation.
  *
  **/
-#include "LinkedList.h"
+#ifndef HASHTABLE_H
+#define HASHTABLE_H
+
+#include "Zobrist.h"
+
+// Returned by retrieveH() for a key that is not in the table
+#define MISSING (-1)
+// Returned by addH() when the table had to grow and could not
+#define NOROOM (-1)
+// Multiplier of SLOTMIX() (2^64 / golden ratio, made odd)
+#define FIBONACCI 0x9E3779B97F4A7C15UL
+// Hash as its slot is picked from: the high bits of the product with 
+// an odd constant, which depend on every bit of the hash.  A Zobrist 
+// hash is a linear function of the configuration, so on boards of few 
+// symbols its own high bits are not spread evenly.
+#define SLOTMIX(h) ((h) * FIBONACCI)
+
+/**
+ * Struct: Slot
+ * ~~~~~~~~~~~~
+ * A single entry in the open-addressed table.  The full hash of the key
+ * is cached so that probing and resizing rarely need to touch the key
+ * itself.
+ *
+ * members
+ * ~~~~~~~
+ * unsigned long hash:  cached hash of key
+ * Word* key:           packed key (NULL if the slot is empty)
+ * long value:          payload (never MISSING)
+ **/
+typedef struct Slot {
+    unsigned long hash;
+    Word* key;
+    long value;
+} Slot;
+
+/**
+ * Struct: Table
+ * ~~~~~~~~~~~~~
+ * Storage behind a Hashtable.  Kept behind a pointer so that a Hashtable
+ * passed by value still sees the table grow.
+ *
+ * members
+ * ~~~~~~~
+ * Slot* entry:     flat array of slots
+ * long size:       number of slots (always a power of two)
+ * long count:      number of occupied slots
+ * int bits:        log2(size)
+ * int width:       number of Words in every key
+ * Zobrist* z:      codes keys are hashed with (NULL to hash their Words)
+ **/
+typedef struct Table {
+    Slot* entry;
+    long size;
+    long count;
+    int bits;
+    int width;
+    Zobrist* z;
+} Table;
 
 /**
  * Struct: Hashtable
  * ~~~~~~~~~~~~~~~~~
- *
- * Fully defines a hashtable.  Includes a pointer to a linked List struct, 
- * upon which pointer arithmetic may be performed to access different 
- * chains of the Hashtable.  
+ * Fully defines a hashtable.  Entries are stored in a single flat array
+ * and collisions are resolved by linear probing.  The table doubles in
+ * size whenever it becomes more than three quarters full.
  *
  * members
  * ~~~~~~~
- * List* entry:     pointer to linked List
- * long size:       number of linked lists
+ * Table* table:    pointer to the underlying storage
  **/
 typedef struct Hashtable {
-    List* entry;
-    long size;
+    Table* table;
 } Hashtable;
 
 /* See Hashtable.c for full explanations */
-int createH(Hashtable* dict, long size);
+int createH(Hashtable* dict, long size, int width, Zobrist* z);
+
+int addH(Hashtable dict, Word* key, long value);
+
+int addHashH(Hashtable dict, Word* key, unsigned long h, long value);
 
-int addH(Hashtable dict, char* key, Triple* triple);
+int reserveH(Hashtable dict, long count);
 
-Triple* retrieveH(Hashtable dict, char* key);
+long retrieveH(Hashtable dict, Word* key);
 
-int removeH(Hashtable dict, char* key);
+long retrieveHashH(Hashtable dict, Word* key, unsigned long h);
+
+int removeH(Hashtable dict, Word* key);
+
+int removeHashH(Hashtable dict, Word* key, unsigned long h);
+
+long nextH(Hashtable dict, long* cursor);
+
+void probesH(Hashtable dict, long* histogram, int nBins);
+
+unsigned long hashH(Word* key, int width);
 
 int destroyH(Hashtable dict);
+
+#endif
@@ -0,0 +1,655 @@
+/**
+ * Level.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Level-synchronous expansion of BFS frontiers.  A whole level is
+ * expanded at once, and its new configurations are appended to the
+ * Nodes of their end, where they make up the next level as one range
+ * of indices.  A single thread adds them to the Hashtable as it finds
+ * them.  Otherwise, worker threads split the frontier, generate
+ * neighbors and look them up in the Hashtable, which nobody writes to
+ * while they run.  Neighbors that were not found are claimed in a
+ * Hashset shared by the workers, so that each new configuration is
+ * kept by exactly one of them without taking a lock, and a single
+ * thread then adds the claimed configurations.  The workers do that in
+ * rounds, so that the Hashset only needs room for part of a level.
+ * Should it fill up, workers keep the rest in buffers of their own,
+ * which the merge checks for duplicates.
+ *
+ * With a Mirror, a configuration reached from GOAL stands for its image 
+ * as well, so every neighbor is also looked up by its image.
+ *
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include "Flip.h"
+#include "Hashset.h"
+#include "Level.h"
+
+// Initial number of unseen neighbors a worker has room for
+#define MINKEPT 64
+
+/**
+ * Struct: Worker
+ * ~~~~~~~~~~~~~~
+ * State of one thread expanding part of a level.
+ *
+ * members
+ * ~~~~~~~
+ * Search* s:           search being expanded
+ * Nodes* nd:           end being expanded
+ * Stop* stop:          shared flag raised once any worker finds a path
+ * Hashset* claims:     unseen neighbors claimed by any worker (NULL if
+ *                      the worker adds them to s->dict itself)
+ * long lo, hi:         range of nodes of nd this worker expands
+ * int depth:           distance of those nodes from their root
+ * Word* batch:         scratch space for getBatch()
+ * unsigned long* codes:    hashes of the keys in batch
+ * Word* keys:          unseen neighbors that did not fit in claims, 
+ *                      s->pk->width Words each
+ * unsigned long* hashes:   hash of each of them
+ * unsigned short* moves:   flip that made each of them, plus MIRRORED 
+ *                          if it is kept as its image
+ * long count, size:    number of them (-1 if out of memory) / room for
+ * long from, to:       refN() of a meeting of the two searches, if one 
+ *                      was found (MISSING otherwise)
+ * double busy:         CPU seconds used by this worker
+ * long expanded[], generated[], duplicates[]:  counts for Stats, by side
+ * double tBatch, tLookup:   seconds in getBatch() and in lookups, if the 
+ *                          Search keeps Stats
+ **/
+typedef struct Worker {
+    Search* s;
+    Nodes* nd;
+    struct Stop* stop;
+    Hashset* claims;
+    long lo;
+    long hi;
+    int depth;
+    Word* batch;
+    unsigned long* codes;
+    Word* keys;
+    unsigned long* hashes;
+    unsigned short* moves;
+    long count;
+    long size;
+    long from;
+    long to;
+    double busy;
+    long expanded[2];
+    long generated[2];
+    long duplicates[2];
+    double tBatch;
+    double tLookup;
+} Worker;
+
+/**
+ * Struct: Stop
+ * ~~~~~~~~~~~~
+ * Lets the first worker to find a path stop the others early.
+ *
+ * members
+ * ~~~~~~~
+ * pthread_mutex_t lock:    protects raised
+ * int raised:              true once a path has been found
+ **/
+typedef struct Stop {
+    pthread_mutex_t lock;
+    int raised;
+} Stop;
+
+// Number of nodes a worker expands between looks at the Stop flag
+#define STOPCHECK 64
+
+static void* expandRange(void* arg);
+static int stopped(Stop* stop, int raise);
+static double cpuSeconds(void);
+static int mergeClaims(Search* s, int a, Worker* wk, int nw);
+static int keepNeighbor(Worker* wk, Word* key, unsigned long hash, 
+        int move);
+static int addNeighbor(Worker* wk, Word* key, unsigned long hash, 
+        int move);
+static int meets(Search* s, int a, int depth, long ref);
+
+/**
+ * Function: expandLevel()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Expands every node of a level of end a using s->threads threads.  
+ * Configurations seen for the first time are appended to s->nodes[a] 
+ * and added to s->dict, and become the next level.
+ *
+ * A single worker adds them itself as it finds them.  Several workers 
+ * claim them in a Hashset, and expand the level in rounds that should 
+ * each add about as many configurations as the set takes, going by 
+ * guessLevel() and then by the rounds before.  After every round the 
+ * claimed configurations are added and the set is emptied; it starts 
+ * with room for MINCLAIMS and doubles after each round that filled it 
+ * more than half, up to MAXCLAIMS.
+ *
+ * If a neighbor of a node turns out to have been reached from the 
+ * other end of the search, and the path through it is short enough, 
+ * the refN() of the two nodes are stored in *from (the node expanded) 
+ * and *to (the node reached from the other end), and whatever the 
+ * level added is taken back out.
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search
+ * a: end being expanded (0 for INITIAL, 1 for GOAL)
+ * level: level to expand, replaced by the next level
+ * from, to: where to store the meeting point
+ *
+ * returns: 1 if the two ends of the search met, 0 if they did not, 
+ *          -1 if memory ran out
+ **/
+int expandLevel(Search* s, int a, Frontier* level, long* from, long* to) {
+    Nodes* nd = s->nodes[a];
+    long count = level->hi - level->lo;
+    int nw = s->threads;
+    if (nw > count) {
+        nw = (count > 0) ? count : 1;
+    }
+    int width = s->pk->width;
+    long next = nd->count;
+    if (!levelN(nd)) {
+        return -1;
+    }
+    Hashset claims;
+    Hashset* set = NULL;
+    if (nw > 1) {
+        if (!createT(&claims, MINCLAIMS, width)) {
+            cutN(nd, nd->nLevels - 1);
+            return -1;
+        }
+        set = &claims;
+    }
+    Worker wk[nw];
+    pthread_t thread[nw];
+    Stop stop;
+    pthread_mutex_init(&stop.lock, NULL);
+    stop.raised = false;
+    int found = 0;
+    for (int i = 0; i < nw; i++) {
+        wk[i].s = s;
+        wk[i].nd = nd;
+        wk[i].stop = &stop;
+        wk[i].claims = set;
+        wk[i].lo = wk[i].hi = level->lo;
+        wk[i].depth = depthN(nd, level->lo);
+        wk[i].batch = malloc(sizeof(Word) * width * (s->nStep + 1));
+        wk[i].codes = malloc(sizeof(unsigned long) * (s->nStep + 1));
+        wk[i].keys = NULL;
+        wk[i].hashes = NULL;
+        wk[i].moves = NULL;
+        wk[i].count = wk[i].size = 0;
+        wk[i].from = wk[i].to = MISSING;
+        wk[i].busy = 0;
+        for (int b = 0; b < 2; b++) {
+            wk[i].expanded[b] = wk[i].generated[b] = 0;
+            wk[i].duplicates[b] = 0;
+        }
+        wk[i].tBatch = wk[i].tLookup = 0;
+        if (wk[i].batch == NULL || wk[i].codes == NULL) {
+            // Expand nothing, and free only the workers set up so far
+            nw = i + 1;
+            found = -1;
+            break;
+        }
+    }
+
+    long guess = guessLevel(s, a, level);
+    long done = level->lo;
+    // Configurations the rounds so far have added
+    long added = 0;
+    while (!found && done < level->hi) {
+        long round = level->hi - done;
+        if (set != NULL) {
+            long want = (done > level->lo) 
+                    ? (done - level->lo) * set->limit / (added + 1)
+                    : (guess > 0) ? count * set->limit / guess : count;
+            round = (want < nw) ? nw : (want < round) ? want : round;
+        }
+        for (int i = 0; i < nw; i++) {
+            wk[i].lo = done + round * i / nw;
+            wk[i].hi = done + round * (i + 1) / nw;
+        }
+        done += round;
+        // The calling thread expands the first range itself
+        for (int i = 1; i < nw; i++) {
+            if (pthread_create(&thread[i], NULL, expandRange, &wk[i])) {
+                // Could not start a thread; do its share here instead
+                expandRange(&wk[i]);
+                thread[i] = pthread_self();
+            }
+        }
+        expandRange(&wk[0]);
+        for (int i = 1; i < nw; i++) {
+            if (!pthread_equal(thread[i], pthread_self())) {
+                pthread_join(thread[i], NULL);
+            }
+        }
+
+        double start = seconds();
+        for (int i = 0; i < nw && !found; i++) {
+            if (wk[i].from != MISSING) {
+                *from = wk[i].from;
+                *to = wk[i].to;
+                found = 1;
+            } else if (wk[i].count < 0) {
+                found = -1;
+            }
+        }
+        if (!found && set != NULL) {
+            long before = nd->count;
+            found = mergeClaims(s, a, wk, nw);
+            added += nd->count - before;
+            long room = set->limit;
+            if (!found && set->count > room / 2 && room < MAXCLAIMS) {
+                destroyT(set);
+                if (!createT(set, 2 * room, width)) {
+                    found = -1;
+                }
+            } else {
+                clearT(set);
+            }
+        }
+        s->merge += seconds() - start;
+        if (s->stats != NULL) {
+            s->stats->merge += seconds() - start;
+        }
+    }
+    if (found) {
+        // Leave nd and dict as they were before the level
+        for (long i = next; i < nd->count; i++) {
+            removeH(s->dict, configN(nd, i));
+        }
+        cutN(nd, nd->nLevels - 1);
+    } else {
+        level->lo = next;
+        level->hi = nd->count;
+    }
+    if (s->stats != NULL) {
+        Stats* st = s->stats;
+        for (int i = 0; i < nw; i++) {
+            for (int b = 0; b < 2; b++) {
+                st->expanded[b] += wk[i].expanded[b];
+                st->generated[b] += wk[i].generated[b];
+                st->duplicates[b] += wk[i].duplicates[b];
+            }
+            st->batch += wk[i].tBatch;
+            st->lookup += wk[i].tLookup;
+        }
+    }
+
+    pthread_mutex_destroy(&stop.lock);
+    if (set != NULL) {
+        destroyT(set);
+    }
+    for (int i = 0; i < nw; i++) {
+        s->busy += wk[i].busy;
+        free(wk[i].batch);
+        free(wk[i].codes);
+        free(wk[i].keys);
+        free(wk[i].hashes);
+        free(wk[i].moves);
+    }
+    return found;
+}
+
+/**
+ * Function: guessLevel()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * Guesses the number of configurations that expanding a level will 
+ * add, assuming it grows by the same factor as it did over the level 
+ * before it (by every flip from the root).
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search
+ * a: end the level belongs to
+ * level: the level
+ *
+ * returns: number of new configurations expected
+ **/
+long guessLevel(Search* s, int a, Frontier* level) {
+    Nodes* nd = s->nodes[a];
+    long count = level->hi - level->lo;
+    int depth = depthN(nd, level->lo);
+    if (depth == 0) {
+        return count * s->nStep;
+    }
+    // Level d of a Nodes starts at start[d - 1], and the root at 0
+    long lo = (depth == 1) ? 0 : nd->start[depth - 2];
+    long prev = level->lo - lo;
+    return (long) ((double) count * count / prev);
+}
+
+/**
+ * Function: seconds()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Reads a monotonic clock.
+ *
+ * returns: time in seconds since an arbitrary starting point
+ **/
+double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Function: findParent()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * Finds the node another node was reached from.  Every flip is its own 
+ * inverse, so making the flip that reached a configuration again takes 
+ * it back to its parent, which is then looked up in s->dict.
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search
+ * nd: Nodes the node belongs to (every one of them in s->dict)
+ * i: index of the node
+ *
+ * returns: index of the parent in nd, NOPARENT for the root
+ **/
+long findParent(Search* s, Nodes* nd, long i) {
+    int move = moveN(nd, i);
+    if (move == NOMOVE) {
+        return NOPARENT;
+    }
+    Packing* pk = s->pk;
+    Word key[pk->width];
+    if (move & MIRRORED) {
+        mirrorM(s->mirror, configN(nd, i), key);
+    } else {
+        memcpy(key, configN(nd, i), sizeof(key));
+    }
+    Move moves[s->nStep + 1];
+    listMoves(s->width, s->height, moves);
+    Move m = moves[move & ~MIRRORED];
+    unsigned char cells[pk->n];
+    unsigned char parent[pk->n];
+    unpackP(pk, key, cells);
+    flipPancake(cells, parent, s->width, s->height, m.fw, m.fh, m.v);
+    packP(pk, parent, key);
+    long ref = retrieveH(s->dict, key);
+    return (ref == MISSING) ? NOPARENT : indexN(ref);
+}
+
+/**
+ * Function: expandRange()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Thread body: expands nodes wk->lo ... wk->hi-1 of wk->nd and records
+ * every neighbor that is not yet in the Hashtable.  Stops early if the
+ * two ends of the search meet.
+ *
+ * input
+ * ~~~~~
+ * arg: pointer to Worker
+ *
+ * returns: NULL
+ **/
+static void* expandRange(void* arg) {
+    Worker* wk = arg;
+    Search* s = wk->s;
+    Nodes* nd = wk->nd;
+    int a = nd->side;
+    int width = s->pk->width;
+    int timed = (s->stats != NULL);
+    Word image[width];
+    double start = cpuSeconds();
+    // Nodes as far as s->maxlen from their root have no neighbors worth 
+    // keeping
+    for (long i = wk->lo; i < wk->hi && wk->depth < s->maxlen 
+            && wk->from == MISSING && wk->count >= 0; i++) {
+        if ((i - wk->lo) % STOPCHECK == STOPCHECK - 1 
+                && stopped(wk->stop, false)) {
+            break;
+        }
+        Word* config = configN(nd, i);
+        double t0 = timed ? seconds() : 0;
+        // Nodes do not keep their hashes, so config is hashed again
+        getBatch(s->pk, config, s->width, s->height, wk->batch, s->z, 
+                keyZ(s->z, config), wk->codes);
+        double t1 = timed ? seconds() : 0;
+        wk->expanded[a]++;
+        wk->generated[a] += s->nStep;
+        for (int j = 0; j < s->nStep; j++) {
+            Word* key = wk->batch + j * width;
+            unsigned long hash = wk->codes[j];
+            int move = j;
+            long ref = retrieveHashH(s->dict, key, hash);
+            if (ref == MISSING && s->mirror != NULL) {
+                mirrorM(s->mirror, key, image);
+                unsigned long imageHash = keyZ(s->z, image);
+                long other = retrieveHashH(s->dict, image, imageHash);
+                // Only GOAL's end stands for images; INITIAL's end 
+                // reaching the image means nothing to INITIAL's end
+                if (other != MISSING && (sideN(other) == 1 || a == 1)) {
+                    ref = other;
+                } else if (a == 1 && compareM(image, key, width) < 0) {
+                    key = image;
+                    hash = imageHash;
+                    move |= MIRRORED;
+                }
+            }
+            if (ref == MISSING && wk->claims == NULL) {
+                if (!addNeighbor(wk, key, hash, move)) {
+                    wk->count = -1;
+                    break;
+                }
+            } else if (ref == MISSING) {
+                // Another worker may have reached it in this level
+                int claim = insertT(wk->claims, key, hash, move);
+                if (claim == PRESENT) {
+                    wk->duplicates[a]++;
+                } else if (claim == FULL 
+                        && !keepNeighbor(wk, key, hash, move)) {
+                    // Tell expandLevel() that memory ran out
+                    wk->count = -1;
+                    break;
+                }
+            } else if (meets(s, a, wk->depth, ref)) {
+                wk->from = refN(a, i);
+                wk->to = ref;
+                stopped(wk->stop, true);
+                break;
+            } else {
+                wk->duplicates[a]++;
+            }
+        }
+        if (timed) {
+            wk->tBatch += t1 - t0;
+            wk->tLookup += seconds() - t1;
+        }
+    }
+    wk->busy += cpuSeconds() - start;
+    return NULL;
+}
+
+/**
+ * Function: stopped()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Reads, and optionally raises, the flag telling workers to stop.
+ *
+ * inputs
+ * ~~~~~~
+ * stop: pointer to Stop
+ * raise: true to raise the flag
+ *
+ * returns: value of the flag
+ **/
+static int stopped(Stop* stop, int raise) {
+    pthread_mutex_lock(&stop->lock);
+    if (raise) {
+        stop->raised = true;
+    }
+    int raised = stop->raised;
+    pthread_mutex_unlock(&stop->lock);
+    return raised;
+}
+
+/**
+ * Function: cpuSeconds()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * Reads the CPU time used by the calling thread, so that time spent 
+ * waiting for a core is not counted as work.
+ *
+ * returns: CPU time of the calling thread in seconds
+ **/
+static double cpuSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Function: mergeClaims()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Appends the configurations a round of workers claimed to the Nodes 
+ * of their end and adds them to s->dict, and then those that did not 
+ * fit in the claims Hashset, which may have been added already.
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search
+ * a: end being expanded
+ * wk: the workers
+ * nw: number of workers
+ *
+ * returns: 0, -1 if memory ran out
+ **/
+static int mergeClaims(Search* s, int a, Worker* wk, int nw) {
+    Nodes* nd = s->nodes[a];
+    Hashset* claims = wk[0].claims;
+    int width = s->pk->width;
+    // The claimed neighbors are all distinct and were not in dict
+    if (!reserveH(s->dict, claims->count)) {
+        return -1;
+    }
+    long cursor = 0;
+    long slot;
+    while ((slot = nextT(claims, &cursor)) >= 0) {
+        long n = addN(nd, keyT(claims, slot), valueT(claims, slot));
+        if (n < 0 || addHashH(s->dict, configN(nd, n), 
+                hashT(claims, slot), refN(a, n)) <= 0) {
+            return -1;
+        }
+    }
+    // Every node of the other end was already in dict, so any neighbor 
+    // found now was added before
+    for (int i = 0; i < nw; i++) {
+        for (long j = 0; j < wk[i].count; j++) {
+            Word* key = wk[i].keys + j * width;
+            unsigned long hash = wk[i].hashes[j];
+            if (retrieveHashH(s->dict, key, hash) != MISSING) {
+                if (s->stats != NULL) {
+                    s->stats->duplicates[a]++;
+                }
+                continue;
+            }
+            long n = addN(nd, key, wk[i].moves[j]);
+            if (n < 0 || addHashH(s->dict, configN(nd, n), hash, 
+                    refN(a, n)) <= 0) {
+                return -1;
+            }
+        }
+        wk[i].count = 0;
+    }
+    return 0;
+}
+
+/**
+ * Function: keepNeighbor()
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ * Appends an unseen neighbor to a worker's private buffers.
+ *
+ * inputs
+ * ~~~~~~
+ * wk: pointer to Worker
+ * key: packed neighbor
+ * hash: hash of key
+ * move: flip that made the neighbor, plus MIRRORED if key is its image
+ *
+ * returns: status
+ **/
+static int keepNeighbor(Worker* wk, Word* key, unsigned long hash, 
+        int move) {
+    int width = wk->s->pk->width;
+    if (wk->count == wk->size) {
+        long size = (wk->size > 0) ? 2 * wk->size : MINKEPT;
+        Word* keys = realloc(wk->keys, sizeof(Word) * width * size);
+        if (keys == NULL) {
+            return false;
+        }
+        wk->keys = keys;
+        unsigned long* hashes = realloc(wk->hashes, 
+                sizeof(unsigned long) * size);
+        if (hashes == NULL) {
+            return false;
+        }
+        wk->hashes = hashes;
+        unsigned short* moves = realloc(wk->moves, 
+                sizeof(unsigned short) * size);
+        if (moves == NULL) {
+            return false;
+        }
+        wk->moves = moves;
+        wk->size = size;
+    }
+    memcpy(wk->keys + wk->count * width, key, sizeof(Word) * width);
+    wk->hashes[wk->count] = hash;
+    wk->moves[wk->count++] = move;
+    return true;
+}
+
+/**
+ * Function: addNeighbor()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Appends an unseen neighbor to the Nodes of a worker's end and adds 
+ * it to s->dict, for a worker that has no one to share them with.
+ *
+ * inputs
+ * ~~~~~~
+ * wk: pointer to Worker
+ * key: packed neighbor
+ * hash: hash of key
+ * move: flip that made the neighbor, plus MIRRORED if key is its image
+ *
+ * returns: status
+ **/
+static int addNeighbor(Worker* wk, Word* key, unsigned long hash, 
+        int move) {
+    Nodes* nd = wk->nd;
+    long n = addN(nd, key, move);
+    return n >= 0 && addHashH(wk->s->dict, configN(nd, n), hash, 
+            refN(nd->side, n)) > 0;
+}
+
+/**
+ * Function: meets()
+ * ~~~~~~~~~~~~~~~~~
+ * Decides whether a neighbor of a node being expanded joins the two 
+ * ends of the search with a path of at most s->maxlen flips.
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search
+ * a: end of the node being expanded
+ * depth: distance of that node from its root
+ * ref: refN() of the neighbor, as found in the Hashtable
+ *
+ * returns: true if the two come from different ends and are close enough
+ **/
+static int meets(Search* s, int a, int depth, long ref) {
+    int b = sideN(ref);
+    return b != a 
+            && depth + depthN(s->nodes[b], indexN(ref)) < s->maxlen;
+}
@@ -0,0 +1,90 @@
+/**
+ * Level.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for level-synchronous expansion of BFS frontiers.
+ *
+ **/
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include "Hashtable.h"
+#include "Mirror.h"
+#include "Nodes.h"
+#include "Stats.h"
+
+// Keys the Hashset that workers claim new configurations in starts out 
+// with room for, and grows to at most (see expandLevel())
+#define MINCLAIMS (1L << 10)
+#define MAXCLAIMS (1L << 17)
+
+/**
+ * Struct: Frontier
+ * ~~~~~~~~~~~~~~~~
+ * One level of a BFS: since every level is added to the Nodes of its 
+ * end in one go, the range of indices lo ... hi-1.
+ *
+ * members
+ * ~~~~~~~
+ * long lo:     first node of the level
+ * long hi:     one past the last node of the level
+ **/
+typedef struct Frontier {
+    long lo;
+    long hi;
+} Frontier;
+
+/**
+ * Struct: Search
+ * ~~~~~~~~~~~~~~
+ * Everything a level expansion needs to know about the search it is
+ * part of, plus timing totals for reporting.
+ *
+ * members
+ * ~~~~~~~
+ * int width, height:   dimensions of the pancake
+ * int maxlen:          maximum flips allowed from initial to goal
+ * int nStep:           number of neighbors of every configuration
+ * int threads:         number of threads expanding each level
+ * Packing* pk:         packing of configurations
+ * Hashtable dict:      every configuration seen so far, as refN() of 
+ *                      its node
+ * Zobrist* z:          codes dict hashes configurations with
+ * Mirror* mirror:      if not NULL, GOAL's end keeps only the smaller of 
+ *                      a configuration and its image
+ * Nodes* nodes[]:      configurations reached from INITIAL and GOAL
+ * double busy:         CPU seconds spent expanding, summed over threads
+ * double merge:        seconds spent adding new configurations to dict
+ * Stats* stats:        counts and timings to add to (NULL for none)
+ **/
+typedef struct Search {
+    int width;
+    int height;
+    int maxlen;
+    int nStep;
+    int threads;
+    Packing* pk;
+    Hashtable dict;
+    Zobrist* z;
+    Mirror* mirror;
+    Nodes* nodes[2];
+    double busy;
+    double merge;
+    Stats* stats;
+} Search;
+
+/* See Level.c for full explanations */
+int expandLevel(Search* s, int a, Frontier* level, long* from, long* to);
+
+long guessLevel(Search* s, int a, Frontier* level);
+
+long findParent(Search* s, Nodes* nd, long i);
+
+double seconds(void);
+
+#endif
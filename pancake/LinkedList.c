@@ -18,24 +18,35 @@
  * Creates an instance of a linked list by setting the head 
  * to NULL.
  *
- * input
- * ~~~~~
+ * With moveToFront, every node retrieveL() finds is moved to the front
+ * of the list, so that keys looked up often are found after few
+ * comparisons.
+ *
+ * inputs
+ * ~~~~~~
  * lst: pointer to List struct
+ * moveToFront: true to move nodes found to the front
  * 
  * returns: status
  **/
-int createL(List* lst) {
+int createL(List* lst, int moveToFront) {
     lst->head = malloc(sizeof(Node));
+    if (lst->head == NULL) {
+        return false;
+    }
     memset(lst->head, 0, sizeof(*(lst->head)));
     (lst->head)->next = NULL;
+    lst->moveToFront = moveToFront;
     return true;
 }
 
 /** 
- * Function: appendL()
- * ~~~~~~~~~~~~~~~~~~~
- * Creates a new load to store pointer to triple struct and appends it 
- * to the end of the linked list.
+ * Function: addL()
+ * ~~~~~~~~~~~~~~~~
+ * Creates a new load to store pointer to triple struct and adds it at 
+ * the front of the linked list, right after the head, so that adding 
+ * takes the same time however long the list is.  The node is keyed by 
+ * triple->config and triple->hash.
  *
  * input
  * ~~~~~
@@ -44,18 +55,15 @@ int createL(List* lst) {
  *
  * returns: status
  **/
-int appendL(List lst, Triple* triple) {
-    Node* prev = lst.head;
-    Node* cur = (lst.head)->next;
-    while (cur != NULL) {
-        prev = cur;
-        cur = cur->next;
+int addL(List lst, Triple* triple) {
+    Node* cur = malloc(sizeof(Node));
+    if (cur == NULL) {
+        return false;
     }
-    prev->next = malloc(sizeof(Node));
-    cur = prev->next;
-    cur->key = triple->config;
+    cur->hash = triple->hash;
     cur->triple = triple;
-    cur->next = NULL;
+    cur->next = (lst.head)->next;
+    (lst.head)->next = cur;
     return true;
 }
 
@@ -82,25 +90,36 @@ int isEmptyL(List lst) {
  * Function: retrieveL()
  * ~~~~~~~~~~~~~~~~~~~~~
  * Retrieves pointer to triple struct associated with a given key, 
- * if it is in the list.  
+ * if it is in the list.  Only nodes with the same hash have their keys 
+ * compared.  In a List made with moveToFront, the node found becomes 
+ * the first one.
  *
  * input
  * ~~~~~
  * lst: List struct
- * key: char string associated with triple to be found
+ * key: packed key associated with triple to be found
+ * hash: hash of key
+ * width: number of Words in key
  *
  * returns: pointer to triple struct if found, NULL otherwise.
  **/
-Triple* retrieveL(List lst, char* key) {
+Triple* retrieveL(List lst, Word* key, unsigned long hash, int width) {
+    Node* prev = lst.head;
     Node* cur = (lst.head)->next;
-    while (cur != NULL && strcmp(key, cur->key)) {
+    while (cur != NULL && (cur->hash != hash 
+            || !sameP(key, cur->triple->config, width))) {
+        prev = cur;
         cur = cur->next;
     }
-    if (cur != NULL) {
-        return cur->triple;
-    } else {
+    if (cur == NULL) {
         return NULL;
     }
+    if (lst.moveToFront && prev != lst.head) {
+        prev->next = cur->next;
+        cur->next = (lst.head)->next;
+        (lst.head)->next = cur;
+    }
+    return cur->triple;
 }
 
 /**
@@ -116,14 +135,17 @@ Triple* retrieveL(List lst, char* key) {
  * input
  * ~~~~~
  * lst: List struct
- * key: char string associated with node to be found
+ * key: packed key associated with node to be found
+ * hash: hash of key
+ * width: number of Words in key
  *
  * returns: status
  **/
-int removeL(List lst, char* key) {
+int removeL(List lst, Word* key, unsigned long hash, int width) {
     Node* prev = lst.head;
     Node* cur = (lst.head)->next;
-    while (cur != NULL && strcmp(key, cur->key)) {
+    while (cur != NULL && (cur->hash != hash 
+            || !sameP(key, cur->triple->config, width))) {
         prev = cur;
         cur = cur->next;
     }
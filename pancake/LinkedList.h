@@ -9,8 +9,12 @@
  * Implementation of headed linked list.
  * 
  **/
+#ifndef LINKEDLIST_H
+#define LINKEDLIST_H
+
 #include <stdbool.h>
 #include <stdlib.h>
+#include "Packing.h"
 
 /** 
  * Struct: Triple
@@ -24,16 +28,18 @@
  *
  * members
  * ~~~~~~~
- * config:  current configuration
+ * config:  current configuration (packed key)
  * prev:    predecessor to config (used as key to access its Triple)
  * len:     distance from root
  * int:     1 if root is GOAL; 0 if root is INITIAL
+ * hash:    hash of config, so neighbors can be hashed incrementally
  **/
 typedef struct Triple {
-    char* config;
-    char* prev;
+    Word* config;
+    Word* prev;
     int len;
     int fromGoal;
+    unsigned long hash;
 } Triple;
 
 /**
@@ -43,12 +49,14 @@ typedef struct Triple {
  *
  * members
  * ~~~~~~~
- * key: character string included to implement hashtable.
+ * hash: hash of the key (triple->config), compared before the key 
+ *       itself so that most other nodes are passed over without 
+ *       reading their Triple
  * triple: pointer to Triple (payload)
  * next: pointer to next node
  **/
 typedef struct Node {
-    char* key;
+    unsigned long hash;
     Triple* triple;
     struct Node* next;
 } Node;
@@ -57,28 +65,30 @@ typedef struct Node {
  * Struct: List
  * ~~~~~~~~~~~~
  * A struct containing a pointer to a single node, the head of the list.
+ * The head is shared by every copy of the List, so a List can be passed
+ * by value and still be changed.
  *
  * members
  * ~~~~~~~
  * head: pointer to head of linked list
+ * moveToFront: true if retrieveL() moves the node it finds to the front
  **/
 typedef struct List {
     Node* head;
+    int moveToFront;
 } List;
 
 /* For full descriptions, please see LinkedList.c */
-int createL(List* lst);
+int createL(List* lst, int moveToFront);
 
-int appendL(List lst, Triple* triple);
+int addL(List lst, Triple* triple);
 
 int isEmptyL(List lst);
 
-Triple* retrieveL(List lst, char* key);
+Triple* retrieveL(List lst, Word* key, unsigned long hash, int width);
 
-int removeL(List lst, char* key);
+int removeL(List lst, Word* key, unsigned long hash, int width);
 
 int destroyL(List lst);
 
-
-
-
+#endif
@@ -0,0 +1,110 @@
+/**
+ * Mirror.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Transpose symmetry of square pancakes.  A configuration and its 
+ * image are the same number of flips from GOAL, so the end of a search 
+ * grown from GOAL only needs to keep one of the two: whichever packs to 
+ * the smaller key.
+ *
+ **/
+#include <string.h>
+#include "Mirror.h"
+
+/**
+ * Function: createM()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Sets up the symmetry of a pancake and GOAL, if it has one: the 
+ * pancake must be square, and relabeling the transpose of GOAL must 
+ * give GOAL back, which it always does when every symbol is distinct.
+ *
+ * inputs
+ * ~~~~~~
+ * m: pointer to Mirror struct
+ * pk: pointer to Packing of configurations
+ * goal: symbol indices of GOAL
+ * w, h: dimensions of the pancake
+ *
+ * returns: true if there is a symmetry, false if not
+ **/
+int createM(Mirror* m, Packing* pk, unsigned char* goal, int w, int h) {
+    if (w != h || w * h > NCHARS) {
+        return false;
+    }
+    m->pk = pk;
+    m->n = w * h;
+    for (int i = 0; i < m->n; i++) {
+        m->cell[i] = (i % w) * w + i / w;
+    }
+    // sigma takes the symbol in each cell of the transpose to the one 
+    // in the same cell of GOAL, and must be one-to-one
+    bool mapped[NCHARS];
+    bool used[NCHARS];
+    memset(mapped, 0, sizeof(mapped));
+    memset(used, 0, sizeof(used));
+    for (int i = 0; i < m->n; i++) {
+        unsigned char from = goal[m->cell[i]];
+        if (mapped[from]) {
+            if (m->sigma[from] != goal[i]) {
+                return false;
+            }
+        } else {
+            if (used[goal[i]]) {
+                return false;
+            }
+            mapped[from] = used[goal[i]] = true;
+            m->sigma[from] = goal[i];
+        }
+    }
+    return true;
+}
+
+/**
+ * Function: mirrorM()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Computes the image of a packed configuration.
+ *
+ * inputs
+ * ~~~~~~
+ * m: pointer to Mirror
+ * key: packed configuration
+ * image: where to store its packed image (not key)
+ *
+ * returns: nothing
+ **/
+void mirrorM(Mirror* m, Word* key, Word* image) {
+    unsigned char cells[m->n];
+    unsigned char moved[m->n];
+    unpackP(m->pk, key, cells);
+    for (int i = 0; i < m->n; i++) {
+        moved[i] = m->sigma[cells[m->cell[i]]];
+    }
+    packP(m->pk, moved, image);
+}
+
+/**
+ * Function: compareM()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Orders packed keys, first Word first, to pick which of a 
+ * configuration and its image to keep.
+ *
+ * inputs
+ * ~~~~~~
+ * a, b: packed keys
+ * width: number of Words in each
+ *
+ * returns: negative, zero or positive as a is below, equal to or above b
+ **/
+int compareM(Word* a, Word* b, int width) {
+    for (int i = 0; i < width; i++) {
+        if (a[i] != b[i]) {
+            return (a[i] < b[i]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+/**
+ * Mirror.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for the transpose symmetry of square pancakes.
+ *
+ **/
+#ifndef MIRROR_H
+#define MIRROR_H
+
+#include "Packing.h"
+
+/**
+ * Struct: Mirror
+ * ~~~~~~~~~~~~~~
+ * The map S taking a configuration x of a square pancake to its 
+ * transpose, relabeled by sigma: S(x)[i] = sigma(x[cell[i]]).  
+ * Transposing turns every vertical flip into a horizontal one and back, 
+ * so S(y) is one flip from S(x) whenever y is one flip from x.  sigma 
+ * is chosen so that S(GOAL) = GOAL, which makes x and S(x) equally far 
+ * from GOAL.  S undoes itself.
+ *
+ * members
+ * ~~~~~~~
+ * Packing* pk:             packing of configurations
+ * int n:                   number of cells
+ * unsigned char cell[]:    cell each cell is transposed from
+ * unsigned char sigma[]:   new symbol index for each symbol index
+ **/
+typedef struct Mirror {
+    Packing* pk;
+    int n;
+    unsigned char cell[NCHARS];
+    unsigned char sigma[NCHARS];
+} Mirror;
+
+/* See Mirror.c for full explanations */
+int createM(Mirror* m, Packing* pk, unsigned char* goal, int w, int h);
+
+void mirrorM(Mirror* m, Word* key, Word* image);
+
+int compareM(Word* a, Word* b, int width);
+
+#endif
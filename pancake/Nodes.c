@@ -0,0 +1,209 @@
+/**
+ * Nodes.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Configurations reached by one end of a search.  Instead of a record
+ * per configuration, each block of nodes holds an array per field.  A 
+ * node only keeps its key and the flip that reached it; its depth is 
+ * that of the level its index falls in.
+ *
+ **/
+#include <string.h>
+#include "Nodes.h"
+
+// Initial number of blocks a Nodes has room for
+#define MINBLOCKS 16
+
+static int addBlock(Nodes* nd);
+
+/**
+ * Function: createN()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Creates an empty Nodes.  No block is allocated until the first call
+ * to addN().
+ *
+ * inputs
+ * ~~~~~~
+ * nd: pointer to Nodes struct
+ * width: number of Words in every key
+ * side: 0 for the end grown from INITIAL, 1 for GOAL
+ *
+ * returns: status
+ **/
+int createN(Nodes* nd, int width, int side) {
+    nd->width = width;
+    nd->side = side;
+    nd->count = 0;
+    nd->nBlocks = MINBLOCKS;
+    nd->nMade = 0;
+    nd->block = malloc(sizeof(Block) * nd->nBlocks);
+    nd->nLevels = 0;
+    nd->size = MINLEVELS;
+    nd->start = malloc(sizeof(long) * nd->size);
+    createA(&nd->arena);
+    return nd->block != NULL && nd->start != NULL;
+}
+
+/**
+ * Function: addN()
+ * ~~~~~~~~~~~~~~~~
+ * Appends a node.
+ *
+ * inputs
+ * ~~~~~~
+ * nd: pointer to Nodes struct
+ * config: packed key (copied)
+ * move: flip config was reached by (NOMOVE for the root), plus MIRRORED
+ *       if config is the image of where it led
+ *
+ * returns: index of the new node, -1 if memory ran out
+ **/
+long addN(Nodes* nd, Word* config, int move) {
+    long i = nd->count;
+    if ((i & NODEMASK) == 0 && !addBlock(nd)) {
+        return -1;
+    }
+    memcpy(configN(nd, i), config, sizeof(Word) * nd->width);
+    moveN(nd, i) = move;
+    return nd->count++;
+}
+
+/**
+ * Function: levelN()
+ * ~~~~~~~~~~~~~~~~~~
+ * Starts a new level: the nodes added from now on are one deeper than 
+ * those added before.  The root is added before the first call.
+ *
+ * input
+ * ~~~~~
+ * nd: pointer to Nodes struct
+ *
+ * returns: status
+ **/
+int levelN(Nodes* nd) {
+    if (nd->nLevels == nd->size) {
+        long* start = realloc(nd->start, sizeof(long) * 2 * nd->size);
+        if (start == NULL) {
+            return false;
+        }
+        nd->start = start;
+        nd->size *= 2;
+    }
+    nd->start[nd->nLevels++] = nd->count;
+    return true;
+}
+
+/**
+ * Function: cutN()
+ * ~~~~~~~~~~~~~~~~
+ * Drops the levels started after the first nLevels calls to levelN(), 
+ * along with their nodes.  The blocks they took are kept for the nodes 
+ * added next.
+ *
+ * inputs
+ * ~~~~~~
+ * nd: pointer to Nodes struct
+ * nLevels: number of levels started to keep
+ *
+ * returns: nothing
+ **/
+void cutN(Nodes* nd, int nLevels) {
+    if (nLevels < nd->nLevels) {
+        nd->count = nd->start[nLevels];
+        nd->nLevels = nLevels;
+    }
+}
+
+/**
+ * Function: depthN()
+ * ~~~~~~~~~~~~~~~~~~
+ * Finds the level a node was added in, by binary search of the first 
+ * node of each level.
+ *
+ * inputs
+ * ~~~~~~
+ * nd: pointer to Nodes struct
+ * i: index of the node
+ *
+ * returns: distance of node i from the root
+ **/
+int depthN(Nodes* nd, long i) {
+    // start[0 ... lo-1] are all at most i, start[hi ...] all above it
+    int lo = 0;
+    int hi = nd->nLevels;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (nd->start[mid] <= i) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * Function: destroyN()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Frees every node.
+ *
+ * input
+ * ~~~~~
+ * nd: pointer to Nodes struct
+ *
+ * returns: status
+ **/
+int destroyN(Nodes* nd) {
+    destroyA(&nd->arena);
+    free(nd->block);
+    free(nd->start);
+    nd->block = NULL;
+    nd->start = NULL;
+    nd->count = nd->nBlocks = 0;
+    nd->nLevels = nd->size = 0;
+    return true;
+}
+
+/**
+ * Function: addBlock()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Allocates the block that node nd->count starts, as one piece of
+ * memory cut into its arrays, unless cutN() left it allocated.
+ *
+ * input
+ * ~~~~~
+ * nd: pointer to Nodes struct
+ *
+ * returns: status
+ **/
+static int addBlock(Nodes* nd) {
+    long b = nd->count >> NODEBITS;
+    if (b < nd->nMade) {
+        return true;
+    }
+    if (b == nd->nBlocks) {
+        Block* block = realloc(nd->block, sizeof(Block) * 2 * nd->nBlocks);
+        if (block == NULL) {
+            return false;
+        }
+        nd->block = block;
+        nd->nBlocks *= 2;
+    }
+    // Longest fields first, so that every array stays aligned
+    char* data = allocA(&nd->arena, NODEBLOCK * (sizeof(Word) * nd->width
+            + sizeof(unsigned short)));
+    if (data == NULL) {
+        return false;
+    }
+    Block* block = &nd->block[b];
+    block->config = (Word*) data;
+    data += NODEBLOCK * sizeof(Word) * nd->width;
+    block->move = (unsigned short*) data;
+    nd->nMade = b + 1;
+    return true;
+}
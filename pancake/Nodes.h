@@ -0,0 +1,117 @@
+/**
+ * Nodes.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for the configurations reached by one end of a search,
+ * kept as parallel arrays.
+ *
+ **/
+#ifndef NODES_H
+#define NODES_H
+
+#include <limits.h>
+#include "Arena.h"
+#include "Packing.h"
+
+// Nodes are kept in blocks of NODEBLOCK
+#define NODEBITS 10
+#define NODEBLOCK (1L << NODEBITS)
+#define NODEMASK (NODEBLOCK - 1)
+// Parent of the root of a search
+#define NOPARENT (-1)
+// Move of the root of a search
+#define NOMOVE USHRT_MAX
+// Added to the move of a node kept as the image of the configuration 
+// the move led to (see Mirror.c)
+#define MIRRORED 0x8000
+// Initial number of levels a Nodes has room for
+#define MINLEVELS 32
+
+/**
+ * Struct: Block
+ * ~~~~~~~~~~~~~
+ * NODEBLOCK consecutive nodes.  Every field is an array of its own, so
+ * that a pass over one field of a range of nodes reads memory in order.
+ *
+ * A node does not point at its parent: every flip is its own inverse, 
+ * so the parent is found again by making the same flip (see 
+ * findParent()).  Nor does it keep its hash, which would take another 
+ * Word per node; a node is hashed again when it is expanded, which 
+ * costs about as much as one of its neighbors.
+ *
+ * members
+ * ~~~~~~~
+ * Word* config:            packed keys, width Words each
+ * unsigned short* move:    index in listMoves() of the flip each was 
+ *                          reached by (NOMOVE for the root), plus 
+ *                          MIRRORED if it is kept as its image
+ **/
+typedef struct Block {
+    Word* config;
+    unsigned short* move;
+} Block;
+
+/**
+ * Struct: Nodes
+ * ~~~~~~~~~~~~~
+ * Every configuration reached by one end of a search, numbered in the
+ * order they were reached, so that each level of a BFS is a range of
+ * indices, and the depth of a node follows from its index.  Blocks 
+ * come from an Arena and never move, so a Hashtable can point at 
+ * their keys.
+ *
+ * members
+ * ~~~~~~~
+ * int width:       number of Words in every key
+ * int side:        0 if the root is INITIAL, 1 if it is GOAL
+ * long count:      number of nodes
+ * Block* block:    the blocks, in order
+ * long nBlocks:    number of blocks block has room for
+ * long nMade:      number of blocks allocated (kept by cutN())
+ * long* start:     first node of each level
+ * int nLevels:     number of levels started
+ * int size:        number of levels start has room for
+ * Arena arena:     storage for the blocks
+ **/
+typedef struct Nodes {
+    int width;
+    int side;
+    long count;
+    Block* block;
+    long nBlocks;
+    long nMade;
+    long* start;
+    int nLevels;
+    int size;
+    Arena arena;
+} Nodes;
+
+// Fields of node i, which can be assigned to
+#define configN(nd, i)  ((nd)->block[(i) >> NODEBITS].config \
+        + ((i) & NODEMASK) * (nd)->width)
+#define moveN(nd, i)    ((nd)->block[(i) >> NODEBITS].move[(i) & NODEMASK])
+
+// A node as stored in a Hashtable: its index and the side it is on
+#define refN(side, i)   (((long) (i) << 1) | (side))
+#define sideN(ref)      ((int) ((ref) & 1))
+#define indexN(ref)     ((ref) >> 1)
+
+/* See Nodes.c for full explanations */
+int createN(Nodes* nd, int width, int side);
+
+long addN(Nodes* nd, Word* config, int move);
+
+int levelN(Nodes* nd);
+
+void cutN(Nodes* nd, int nLevels);
+
+int depthN(Nodes* nd, long i);
+
+int destroyN(Nodes* nd);
+
+#endif
@@ -0,0 +1,243 @@
+/**
+ * Packing.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Implementation of fixed-width binary encoding of configurations.  A
+ * configuration of n cells becomes a key of a few 64-bit words, so
+ * hashing and equality can work a word at a time instead of a
+ * character at a time.
+ *
+ **/
+#include <string.h>
+#include "Packing.h"
+
+// Bits per Word
+#define WORDBITS 64
+
+/**
+ * Function: createP()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Chooses the symbol numbering and key layout for configurations that
+ * are permutations of config.
+ *
+ * inputs
+ * ~~~~~~
+ * pk: pointer to Packing struct
+ * config: any configuration (only its multiset of characters matters)
+ * n: number of cells
+ *
+ * returns: status
+ **/
+int createP(Packing* pk, char* config, int n) {
+    int count[NCHARS];
+    memset(count, 0, sizeof(count));
+    for (int i = 0; i < n; i++) {
+        count[(unsigned char) config[i]]++;
+    }
+    pk->n = n;
+    pk->nSymbols = 0;
+    bool distinct = true;
+    for (int c = 0; c < NCHARS; c++) {
+        if (count[c] > 0) {
+            pk->symbol[pk->nSymbols] = c;
+            pk->index[c] = pk->nSymbols++;
+        }
+        if (count[c] > 1) {
+            distinct = false;
+        }
+    }
+    if (pk->nSymbols <= 16) {
+        pk->layout = NIBBLE;
+        pk->width = (4 * n + WORDBITS - 1) / WORDBITS;
+    } else if (distinct && n <= MAXRANKN) {
+        pk->layout = RANK;
+        pk->width = 1;
+    } else {
+        pk->layout = BYTE;
+        pk->width = (8 * n + WORDBITS - 1) / WORDBITS;
+    }
+    return true;
+}
+
+/**
+ * Function: packP()
+ * ~~~~~~~~~~~~~~~~~
+ * Packs an array of symbol indices into a key.
+ *
+ * inputs
+ * ~~~~~~
+ * pk: pointer to Packing struct
+ * cells: n symbol indices
+ * key: width Words to fill
+ *
+ * returns: nothing
+ **/
+void packP(Packing* pk, unsigned char* cells, Word* key) {
+    if (pk->layout == RANK) {
+        key[0] = rankP(cells, pk->n);
+        return;
+    }
+    int bits = (pk->layout == NIBBLE) ? 4 : 8;
+    int perWord = WORDBITS / bits;
+    memset(key, 0, sizeof(Word) * pk->width);
+    for (int i = 0; i < pk->n; i++) {
+        key[i / perWord] |= (Word) cells[i] << ((i % perWord) * bits);
+    }
+}
+
+/**
+ * Function: unpackP()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Inverse of packP().
+ *
+ * inputs
+ * ~~~~~~
+ * pk: pointer to Packing struct
+ * key: packed key
+ * cells: array of n symbol indices to fill
+ *
+ * returns: nothing
+ **/
+void unpackP(Packing* pk, Word* key, unsigned char* cells) {
+    if (pk->layout == RANK) {
+        unrankP(key[0], pk->n, cells);
+        return;
+    }
+    int bits = (pk->layout == NIBBLE) ? 4 : 8;
+    int perWord = WORDBITS / bits;
+    Word mask = ((Word) 1 << bits) - 1;
+    for (int i = 0; i < pk->n; i++) {
+        cells[i] = (key[i / perWord] >> ((i % perWord) * bits)) & mask;
+    }
+}
+
+/**
+ * Function: encodeP()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Packs a character string configuration into a key.
+ *
+ * inputs
+ * ~~~~~~
+ * pk: pointer to Packing struct
+ * config: string of n characters
+ * key: width Words to fill
+ *
+ * returns: nothing
+ **/
+void encodeP(Packing* pk, char* config, Word* key) {
+    unsigned char cells[pk->n];
+    for (int i = 0; i < pk->n; i++) {
+        cells[i] = pk->index[(unsigned char) config[i]];
+    }
+    packP(pk, cells, key);
+}
+
+/**
+ * Function: decodeP()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Unpacks a key into a NUL-terminated character string.
+ *
+ * inputs
+ * ~~~~~~
+ * pk: pointer to Packing struct
+ * key: packed key
+ * config: buffer of at least n + 1 characters
+ *
+ * returns: nothing
+ **/
+void decodeP(Packing* pk, Word* key, char* config) {
+    unsigned char cells[pk->n];
+    unpackP(pk, key, cells);
+    for (int i = 0; i < pk->n; i++) {
+        config[i] = pk->symbol[cells[i]];
+    }
+    config[pk->n] = '\0';
+}
+
+/**
+ * Function: sameP()
+ * ~~~~~~~~~~~~~~~~~
+ * Compares two keys a word at a time.
+ *
+ * inputs
+ * ~~~~~~
+ * a, b: packed keys
+ * width: number of Words in each key
+ *
+ * returns: true if the keys are equal, false otherwise
+ **/
+bool sameP(Word* a, Word* b, int width) {
+    for (int i = 0; i < width; i++) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Function: rankP()
+ * ~~~~~~~~~~~~~~~~~
+ * Linear-time permutation ranking of Myrvold and Ruskey.  Ranks are a
+ * bijection between permutations of 0 ... n-1 and 0 ... n!-1, though not
+ * in lexicographic order.
+ *
+ * inputs
+ * ~~~~~~
+ * cells: a permutation of 0 ... n-1
+ * n: number of cells (at most MAXRANKN)
+ *
+ * returns: rank of cells
+ **/
+Word rankP(unsigned char* cells, int n) {
+    unsigned char perm[n];
+    unsigned char inv[n];
+    for (int i = 0; i < n; i++) {
+        perm[i] = cells[i];
+        inv[cells[i]] = i;
+    }
+    Word rank = 0;
+    Word radix = 1;
+    for (int i = n; i > 1; i--) {
+        unsigned char s = perm[i - 1];
+        unsigned char t = inv[i - 1];
+        perm[i - 1] = perm[t];
+        perm[t] = s;
+        inv[s] = t;
+        inv[i - 1] = i - 1;
+        rank += s * radix;
+        radix *= i;
+    }
+    return rank;
+}
+
+/**
+ * Function: unrankP()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Inverse of rankP().
+ *
+ * inputs
+ * ~~~~~~
+ * rank: rank of a permutation of 0 ... n-1
+ * n: number of cells
+ * cells: array of n cells to fill
+ *
+ * returns: nothing
+ **/
+void unrankP(Word rank, int n, unsigned char* cells) {
+    for (int i = 0; i < n; i++) {
+        cells[i] = i;
+    }
+    for (int i = n; i > 0; i--) {
+        int j = rank % i;
+        unsigned char s = cells[i - 1];
+        cells[i - 1] = cells[j];
+        cells[j] = s;
+        rank /= i;
+    }
+}
@@ -0,0 +1,79 @@
+/**
+ * Packing.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for fixed-width binary encoding of configurations.
+ *
+ **/
+#ifndef PACKING_H
+#define PACKING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Packed configurations are arrays of 64-bit words
+typedef uint64_t Word;
+
+// Number of distinct byte values a cell may hold
+#define NCHARS 256
+
+// Layouts of a packed configuration
+// NIBBLE: 4 bits per cell (at most 16 distinct symbols)
+// RANK:   permutation rank in a single word (all symbols distinct)
+// BYTE:   8 bits per cell (anything else)
+#define NIBBLE 0
+#define RANK 1
+#define BYTE 2
+
+// Largest number of distinct cells whose rank fits in a Word (20! < 2^64)
+#define MAXRANKN 20
+
+/**
+ * Struct: Packing
+ * ~~~~~~~~~~~~~~~
+ * Describes how configurations over a fixed multiset of characters are
+ * packed into keys of width Words.  Cells are first mapped to small
+ * symbol indices (0 ... nSymbols-1, in character order).
+ *
+ * members
+ * ~~~~~~~
+ * int n:               number of cells in a configuration
+ * int nSymbols:        number of distinct characters
+ * int layout:          one of NIBBLE, RANK, BYTE
+ * int width:           number of Words in a packed key
+ * char symbol[]:       character for each symbol index
+ * unsigned char index[]:   symbol index for each character
+ **/
+typedef struct Packing {
+    int n;
+    int nSymbols;
+    int layout;
+    int width;
+    char symbol[NCHARS];
+    unsigned char index[NCHARS];
+} Packing;
+
+/* See Packing.c for full explanations */
+int createP(Packing* pk, char* config, int n);
+
+void packP(Packing* pk, unsigned char* cells, Word* key);
+
+void unpackP(Packing* pk, Word* key, unsigned char* cells);
+
+void encodeP(Packing* pk, char* config, Word* key);
+
+void decodeP(Packing* pk, Word* key, char* config);
+
+bool sameP(Word* a, Word* b, int width);
+
+Word rankP(unsigned char* cells, int n);
+
+void unrankP(Word rank, int n, unsigned char* cells);
+
+#endif
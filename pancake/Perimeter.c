@@ -0,0 +1,267 @@
+/**
+ * Perimeter.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Perimeter search: once a bidirectional BFS may not grow its table any
+ * further, the table is frozen and the search carries on depth first
+ * from every configuration on the last level of INITIAL's end.  Every
+ * configuration within radius flips of GOAL is in the table with its
+ * exact distance, and every other one is at least radius + 1 flips
+ * away, which makes an exact bound for iterative deepening.  Apart from
+ * the table, only the current path is kept.
+ *
+ **/
+#include <limits.h>
+#include <string.h>
+#include "Bound.h"
+#include "Perimeter.h"
+
+/**
+ * Struct: Perimeter
+ * ~~~~~~~~~~~~~~~~~
+ * State of a perimeter search.
+ *
+ * members
+ * ~~~~~~~
+ * Search* s:           search whose table is frozen
+ * Move* moves:         every flip
+ * unsigned char* path: configurations on the current path, n each,
+ *                      starting from a node of INITIAL's last level
+ * int* last:           index of the flip that produced each of them
+ * Word* key:           scratch space for a packed key
+ * Word* image:         scratch space for its image
+ * Bound b:             lower bound on the distance to GOAL
+ * int n:               number of cells
+ * int start:           depth of INITIAL's last level
+ * int radius:          depth of GOAL's last level
+ * int depth:           depth on path at which GOAL's end was reached
+ * long to:             node of GOAL's end reached
+ * long expanded, generated:    counts for Stats
+ **/
+typedef struct Perimeter {
+    Search* s;
+    Move* moves;
+    unsigned char* path;
+    int* last;
+    Word* key;
+    Word* image;
+    Bound b;
+    int n;
+    int start;
+    int radius;
+    int depth;
+    long to;
+    long expanded;
+    long generated;
+} Perimeter;
+
+// Returned by dfs() once GOAL's end has been reached
+#define FOUND -1
+
+static int dfs(Perimeter* p, int g, int bound);
+static int distance(Perimeter* p, unsigned char* cells, int g);
+
+/**
+ * Function: perimeterSearch()
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Finds a shortest path from INITIAL to GOAL that the table of a BFS is
+ * too small to hold.  Both ends must have stopped after complete levels
+ * without meeting: INITIAL's end start levels deep, GOAL's end radius
+ * levels deep.  Every path then has at least start + radius + 1 flips
+ * and passes through a node of INITIAL's last level, from which depth
+ * first searches are made with a threshold on g + distance to GOAL that
+ * is raised until GOAL's end is reached or it passes s->maxlen.
+ *
+ * A configuration that is in INITIAL's end cannot be on a shortest
+ * path any deeper than it already is, so it is cut off, and a flip is
+ * never immediately undone.
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search (s->dict is only read)
+ * level: last level of INITIAL's end
+ * start: depth of that level
+ * radius: depth of GOAL's last level
+ * from: where to store the node of level the path goes through
+ * path: where to store a malloc'd array of the configurations after
+ *       from, up to and including the one in GOAL's end, n symbol
+ *       indices each (NULL if there is no path)
+ * to: where to store the node of GOAL's end the path reaches
+ *
+ * returns: number of configurations in *path, -1 if there is no path,
+ *          -2 if memory ran out
+ **/
+int perimeterSearch(Search* s, Frontier* level, int start, int radius,
+        long* from, unsigned char** path, long* to) {
+    Perimeter p;
+    p.s = s;
+    p.n = s->width * s->height;
+    p.start = start;
+    p.radius = radius;
+    p.expanded = p.generated = 0;
+    p.path = NULL;
+    p.last = NULL;
+    p.moves = malloc(sizeof(Move) * (s->nStep + 1));
+    p.key = malloc(sizeof(Word) * s->pk->width);
+    p.image = malloc(sizeof(Word) * s->pk->width);
+    unsigned char goal[p.n];
+    unpackP(s->pk, configN(s->nodes[1], 0), goal);
+    int ok = createB(&p.b, goal, s->width, s->height, s->pk->nSymbols);
+    int flips = -2;
+    if (ok && p.moves != NULL && p.key != NULL && p.image != NULL) {
+        listMoves(s->width, s->height, p.moves);
+        flips = -1;
+    }
+
+    int bound = start + radius + 1;
+    while (flips == -1 && bound <= s->maxlen) {
+        // Children of the path are at most one flip past the threshold
+        int room = bound - start + 2;
+        unsigned char* more = realloc(p.path, p.n * room);
+        if (more != NULL) {
+            p.path = more;
+        }
+        int* last = realloc(p.last, sizeof(int) * room);
+        if (last != NULL) {
+            p.last = last;
+        }
+        if (more == NULL || last == NULL) {
+            flips = -2;
+            break;
+        }
+        int least = INT_MAX;
+        for (long i = level->lo; i < level->hi; i++) {
+            unpackP(s->pk, configN(s->nodes[0], i), p.path);
+            p.last[0] = -1;
+            int next = dfs(&p, 0, bound);
+            if (next == FOUND) {
+                *from = i;
+                *to = p.to;
+                flips = p.depth;
+                break;
+            }
+            if (next < least) {
+                least = next;
+            }
+        }
+        bound = least;
+    }
+    if (s->stats != NULL) {
+        s->stats->expanded[0] += p.expanded;
+        s->stats->generated[0] += p.generated;
+    }
+    if (flips < 0) {
+        free(p.path);
+        p.path = NULL;
+    } else {
+        // The node of level itself was printed with INITIAL's end
+        memmove(p.path, p.path + p.n, p.n * flips);
+    }
+    *path = p.path;
+    free(p.moves);
+    free(p.last);
+    free(p.key);
+    free(p.image);
+    destroyB(&p.b);
+    return flips;
+}
+
+/**
+ * Function: dfs()
+ * ~~~~~~~~~~~~~~~
+ * One depth-first pass below the configuration at depth g of the
+ * current path.  When GOAL's end is reached, the depth is left in
+ * p->depth and the node reached in p->to.
+ *
+ * inputs
+ * ~~~~~~
+ * p: pointer to Perimeter
+ * g: depth of the configuration to expand
+ * bound: threshold on start + g + distance to GOAL
+ *
+ * returns: FOUND, or the smallest such sum that was cut off
+ **/
+static int dfs(Perimeter* p, int g, int bound) {
+    unsigned char* cur = p->path + g * p->n;
+    int h = distance(p, cur, g);
+    if (h < 0) {
+        return INT_MAX;
+    }
+    int f = p->start + g + h;
+    if (f > bound) {
+        return f;
+    }
+    if (h <= p->radius) {
+        p->depth = g;
+        return FOUND;
+    }
+    int least = INT_MAX;
+    Search* s = p->s;
+    p->expanded++;
+    for (int i = 0; i < s->nStep; i++) {
+        if (i == p->last[g]) {
+            continue;
+        }
+        Move m = p->moves[i];
+        flipPancake(cur, cur + p->n, s->width, s->height, m.fw, m.fh, m.v);
+        p->last[g + 1] = i;
+        p->generated++;
+        int next = dfs(p, g + 1, bound);
+        if (next == FOUND) {
+            return FOUND;
+        }
+        if (next < least) {
+            least = next;
+        }
+    }
+    return least;
+}
+
+/**
+ * Function: distance()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Looks a configuration up in the frozen table.  With a Mirror, GOAL's
+ * end may hold its image instead.  Outside both ends, the distance to
+ * GOAL is at least radius + 1 and at least what the Bound says.
+ *
+ * inputs
+ * ~~~~~~
+ * p: pointer to Perimeter
+ * cells: symbol indices of the configuration
+ * g: its depth on the current path
+ *
+ * returns: its distance to GOAL if it is in GOAL's end (the node is left
+ *          in p->to), a lower bound on it if it is in neither end, -1 if
+ *          it is in INITIAL's end
+ **/
+static int distance(Perimeter* p, unsigned char* cells, int g) {
+    Search* s = p->s;
+    long ref = MISSING;
+    // A node of INITIAL's last level would already have met GOAL's end
+    if (g > 0) {
+        packP(s->pk, cells, p->key);
+        ref = retrieveH(s->dict, p->key);
+        // INITIAL's end only goes start deep, which is less than start + g
+        if (ref != MISSING && sideN(ref) == 0) {
+            return -1;
+        }
+        if (ref == MISSING && s->mirror != NULL) {
+            mirrorM(s->mirror, p->key, p->image);
+            ref = retrieveH(s->dict, p->image);
+            if (ref != MISSING && sideN(ref) == 0) {
+                ref = MISSING;
+            }
+        }
+    }
+    if (ref == MISSING) {
+        int h = estimateB(&p->b, cells);
+        return (h > p->radius) ? h : p->radius + 1;
+    }
+    p->to = indexN(ref);
+    return depthN(s->nodes[1], p->to);
+}
@@ -0,0 +1,24 @@
+/**
+ * Perimeter.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for iterative deepening from the frontier of INITIAL's end
+ * of a BFS against the levels already found around GOAL.
+ *
+ **/
+#ifndef PERIMETER_H
+#define PERIMETER_H
+
+#include "Flip.h"
+#include "Level.h"
+
+/* See Perimeter.c for full explanations */
+int perimeterSearch(Search* s, Frontier* level, int start, int radius,
+        long* from, unsigned char** path, long* to);
+
+#endif
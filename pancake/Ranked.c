@@ -0,0 +1,339 @@
+/**
+ * Ranked.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Bidirectional BFS over permutation ranks.  Where the Hashtable search 
+ * spends a node of Nodes (a packed key and a flip) and a slot on every 
+ * configuration, this one spends 4 bits on every permutation, reached or not, plus a rank 
+ * in a frontier while a configuration is on one.  It therefore only 
+ * pays off once a search has reached a good share of all permutations.
+ *
+ **/
+#include <string.h>
+#include "Ranked.h"
+
+// Initial number of ranks a Ranks has room for
+#define MINRANKS 64
+
+static int expand(Ranked* r, int a, Ranks* next, Word meet[2]);
+static void trace(Ranked* r, int a, Word rank, int depth, 
+        unsigned char* path, int step);
+static int getCode(Ranked* r, Word rank, int a);
+static void setCode(Ranked* r, Word rank, int a, int depth);
+static int createRanks(Ranks* rs);
+static int pushR(Ranks* rs, Word rank);
+
+/**
+ * Function: bytesR()
+ * ~~~~~~~~~~~~~~~~~~
+ * input
+ * ~~~~~
+ * n: number of cells (at most MAXRANKEDN)
+ *
+ * returns: number of bytes of codes a Ranked needs for n cells
+ **/
+Word bytesR(int n) {
+    Word entries = 1;
+    for (int i = 2; i <= n; i++) {
+        entries *= i;
+    }
+    return (entries + 1) / 2;
+}
+
+/**
+ * Function: createR()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Creates a Ranked in which neither side has reached anything.
+ *
+ * inputs
+ * ~~~~~~
+ * r: pointer to Ranked struct
+ * w, h: dimensions of the pancake (at most MAXRANKEDN cells)
+ *
+ * returns: status
+ **/
+int createR(Ranked* r, int w, int h) {
+    r->width = w;
+    r->height = h;
+    r->n = w * h;
+    r->nStep = countMoves(w, h);
+    r->entries = 2 * bytesR(r->n);
+    r->depth[0] = r->depth[1] = 0;
+    for (int a = 0; a < 2; a++) {
+        r->expanded[a] = r->generated[a] = r->duplicates[a] = 0;
+    }
+    r->moves = malloc(sizeof(Move) * (r->nStep + 1));
+    // Pages of codes are only touched once a rank on them is reached
+    r->code = calloc(bytesR(r->n), 1);
+    int ok = createRanks(&r->side[0]) & createRanks(&r->side[1]);
+    if (r->moves == NULL || r->code == NULL || !ok) {
+        destroyR(r);
+        return false;
+    }
+    listMoves(w, h, r->moves);
+    return true;
+}
+
+/**
+ * Function: addR()
+ * ~~~~~~~~~~~~~~~~
+ * Records that side a has reached a configuration.
+ *
+ * inputs
+ * ~~~~~~
+ * r: pointer to Ranked struct
+ * a: side (0 for INITIAL, 1 for GOAL)
+ * cells: the configuration, a permutation of 0 ... n-1
+ * depth: its distance from the root of side a
+ * frontier: true if it is on the frontier of side a
+ *
+ * returns: status
+ **/
+int addR(Ranked* r, int a, unsigned char* cells, int depth, int frontier) {
+    Word rank = rankP(cells, r->n);
+    setCode(r, rank, a, depth);
+    return !frontier || pushR(&r->side[a], rank);
+}
+
+/**
+ * Function: searchR()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Carries on a bidirectional BFS from where the sides are, expanding 
+ * one whole level of whichever frontier is smaller at every step, as 
+ * levelSearch() does.  With dI and dG complete levels and no earlier 
+ * meeting, the first neighbor found on the other side gives a shortest 
+ * path, and that neighbor is on the other side's frontier.
+ *
+ * inputs
+ * ~~~~~~
+ * r: pointer to Ranked struct (sides that have not met yet)
+ * maxlen: maximum number of flips
+ * path: where to store a malloc'd array of the configurations on the 
+ *       path, n cells each (NULL if there is no path)
+ *
+ * returns: number of flips in the path, -1 if there is none, -2 if 
+ *          memory ran out
+ **/
+int searchR(Ranked* r, int maxlen, unsigned char** path) {
+    Ranks next;
+    *path = NULL;
+    if (!createRanks(&next)) {
+        return -2;
+    }
+    // meet[0] and meet[1] are reached from INITIAL and GOAL, one flip apart
+    Word meet[2];
+    int found = 0;
+    while (!found && r->depth[0] + r->depth[1] < maxlen) {
+        int a = (r->side[1].count < r->side[0].count) ? 1 : 0;
+        // A side with nothing left to expand has seen every 
+        // configuration it can reach, none of which met the other side
+        if (r->side[a].count == 0) {
+            break;
+        }
+        found = expand(r, a, &next, meet);
+        if (found != 0) {
+            break;
+        }
+        Ranks swap = r->side[a];
+        r->side[a] = next;
+        next = swap;
+        next.count = 0;
+        r->depth[a]++;
+    }
+    free(next.item);
+    if (found <= 0) {
+        return found - 1;
+    }
+    int flips = r->depth[0] + r->depth[1] + 1;
+    *path = malloc(r->n * (flips + 1));
+    if (*path == NULL) {
+        return -2;
+    }
+    trace(r, 0, meet[0], r->depth[0], *path + r->depth[0] * r->n, -1);
+    trace(r, 1, meet[1], r->depth[1], *path + (r->depth[0] + 1) * r->n, 1);
+    return flips;
+}
+
+/**
+ * Function: destroyR()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Frees all memory associated with a Ranked.
+ *
+ * input
+ * ~~~~~
+ * r: pointer to Ranked struct
+ *
+ * returns: status
+ **/
+int destroyR(Ranked* r) {
+    free(r->moves);
+    free(r->code);
+    free(r->side[0].item);
+    free(r->side[1].item);
+    r->moves = NULL;
+    r->code = NULL;
+    r->side[0].item = r->side[1].item = NULL;
+    return true;
+}
+
+/**
+ * Function: expand()
+ * ~~~~~~~~~~~~~~~~~~
+ * Expands the frontier of side a into next, stopping at the first 
+ * neighbor already reached by the other side.
+ *
+ * inputs
+ * ~~~~~~
+ * r: pointer to Ranked
+ * a: side being expanded
+ * next: empty frontier for the level after it
+ * meet: where to store the ranks on either side of a meeting
+ *
+ * returns: 1 if the two sides met, 0 if not, -1 if memory ran out
+ **/
+static int expand(Ranked* r, int a, Ranks* next, Word meet[2]) {
+    Ranks* cur = &r->side[a];
+    unsigned char old[r->n];
+    unsigned char new[r->n];
+    for (long i = 0; i < cur->count; i++) {
+        unrankP(cur->item[i], r->n, old);
+        r->expanded[a]++;
+        r->generated[a] += r->nStep;
+        for (int j = 0; j < r->nStep; j++) {
+            Move m = r->moves[j];
+            flipPancake(old, new, r->width, r->height, m.fw, m.fh, m.v);
+            Word q = rankP(new, r->n);
+            if (getCode(r, q, !a) != 0) {
+                meet[a] = cur->item[i];
+                meet[!a] = q;
+                return 1;
+            }
+            if (getCode(r, q, a) == 0) {
+                setCode(r, q, a, r->depth[a] + 1);
+                if (!pushR(next, q)) {
+                    return -1;
+                }
+            } else {
+                r->duplicates[a]++;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * Function: trace()
+ * ~~~~~~~~~~~~~~~~~
+ * Writes the configurations from a rank back to the root of side a, 
+ * finding at every step the neighbor one level closer.
+ *
+ * inputs
+ * ~~~~~~
+ * r: pointer to Ranked
+ * a: side the rank was reached by
+ * rank: rank to start from
+ * depth: its depth on side a
+ * path: where to write its configuration
+ * step: +1 to write the following ones after it, -1 before it
+ *
+ * returns: nothing
+ **/
+static void trace(Ranked* r, int a, Word rank, int depth, 
+        unsigned char* path, int step) {
+    unsigned char* cur = path;
+    unrankP(rank, r->n, cur);
+    for (; depth > 0; depth--) {
+        unsigned char* next = cur + step * r->n;
+        for (int j = 0; j < r->nStep; j++) {
+            Move m = r->moves[j];
+            flipPancake(cur, next, r->width, r->height, m.fw, m.fh, m.v);
+            if (getCode(r, rankP(next, r->n), a) == (depth - 1) % 3 + 1) {
+                break;
+            }
+        }
+        cur = next;
+    }
+}
+
+/**
+ * Function: getCode()
+ * ~~~~~~~~~~~~~~~~~~~
+ * inputs
+ * ~~~~~~
+ * r: pointer to Ranked
+ * rank: rank of a configuration
+ * a: side
+ *
+ * returns: 0 if side a has not reached rank, 1 + (depth mod 3) if it has
+ **/
+static int getCode(Ranked* r, Word rank, int a) {
+    return (r->code[rank / 2] >> ((rank % 2) * 4 + a * 2)) & 3;
+}
+
+/**
+ * Function: setCode()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Records that side a has reached rank at a given depth.
+ *
+ * inputs
+ * ~~~~~~
+ * r: pointer to Ranked
+ * rank: rank of a configuration
+ * a: side
+ * depth: its depth on side a
+ *
+ * returns: nothing
+ **/
+static void setCode(Ranked* r, Word rank, int a, int depth) {
+    int shift = (rank % 2) * 4 + a * 2;
+    r->code[rank / 2] = (r->code[rank / 2] & ~(3 << shift)) 
+            | ((depth % 3 + 1) << shift);
+}
+
+/**
+ * Function: createRanks()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Creates an empty Ranks.
+ *
+ * input
+ * ~~~~~
+ * rs: pointer to Ranks
+ *
+ * returns: status
+ **/
+static int createRanks(Ranks* rs) {
+    rs->count = 0;
+    rs->size = MINRANKS;
+    rs->item = malloc(sizeof(Word) * rs->size);
+    return rs->item != NULL;
+}
+
+/**
+ * Function: pushR()
+ * ~~~~~~~~~~~~~~~~~
+ * Appends a rank to a Ranks, growing it if necessary.
+ *
+ * inputs
+ * ~~~~~~
+ * rs: pointer to Ranks
+ * rank: rank to append
+ *
+ * returns: status
+ **/
+static int pushR(Ranks* rs, Word rank) {
+    if (rs->count == rs->size) {
+        Word* item = realloc(rs->item, sizeof(Word) * 2 * rs->size);
+        if (item == NULL) {
+            return false;
+        }
+        rs->item = item;
+        rs->size *= 2;
+    }
+    rs->item[rs->count++] = rank;
+    return true;
+}
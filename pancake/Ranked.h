@@ -0,0 +1,91 @@
+/**
+ * Ranked.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for bidirectional BFS over permutation ranks, used when 
+ * every symbol of a configuration is distinct.
+ *
+ **/
+#ifndef RANKED_H
+#define RANKED_H
+
+#include "Flip.h"
+
+// Largest number of cells searched by rank (12! states, 4 bits each)
+#define MAXRANKEDN 12
+
+/**
+ * Struct: Ranks
+ * ~~~~~~~~~~~~~
+ * A growable array of ranks making up one level of the search.
+ *
+ * members
+ * ~~~~~~~
+ * Word* item:  the ranks
+ * long count:  number of ranks in item
+ * long size:   number of ranks item has room for
+ **/
+typedef struct Ranks {
+    Word* item;
+    long count;
+    long size;
+} Ranks;
+
+/**
+ * Struct: Ranked
+ * ~~~~~~~~~~~~~~
+ * State of a bidirectional BFS in which configurations are permutations 
+ * of 0 ... n-1 known only by their rankP().  Instead of Nodes holding 
+ * a key and a flip for each configuration reached, with a Hashtable to 
+ * find them, every rank has 4 bits: 2 per side, holding 0 if that side 
+ * has not reached it and 1 + (depth mod 3) if it has.  Neighbors differ 
+ * in depth by at most one, so the neighbor one level closer to a root 
+ * is the one whose code is that of the depth below, and paths can be 
+ * traced back without storing parents.
+ *
+ * Side 0 grows from INITIAL and side 1 from GOAL.
+ *
+ * members
+ * ~~~~~~~
+ * int width, height:   dimensions of the pancake
+ * int n:               number of cells
+ * int nStep:           number of flips
+ * Move* moves:         every flip
+ * Word entries:        number of permutations (n!)
+ * unsigned char* code: codes of two ranks per byte
+ * Ranks side[]:        frontier of each side
+ * int depth[]:         number of levels each side has expanded
+ * long expanded[], generated[], duplicates[]:  counts for Stats, by side
+ **/
+typedef struct Ranked {
+    int width;
+    int height;
+    int n;
+    int nStep;
+    Move* moves;
+    Word entries;
+    unsigned char* code;
+    Ranks side[2];
+    int depth[2];
+    long expanded[2];
+    long generated[2];
+    long duplicates[2];
+} Ranked;
+
+/* See Ranked.c for full explanations */
+Word bytesR(int n);
+
+int createR(Ranked* r, int w, int h);
+
+int addR(Ranked* r, int a, unsigned char* cells, int depth, int frontier);
+
+int searchR(Ranked* r, int maxlen, unsigned char** path);
+
+int destroyR(Ranked* r);
+
+#endif
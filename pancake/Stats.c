@@ -0,0 +1,193 @@
+/**
+ * Stats.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Counts and timings of BFS searches, reported as text or JSON.  The 
+ * counts are kept by every worker anyway and only summed here; the 
+ * timings cost two reads of the clock per configuration expanded.
+ *
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <string.h>
+#include <sys/resource.h>
+#include "Level.h"
+#include "Stats.h"
+
+static long peakKB(void);
+
+/**
+ * Function: createS()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Creates Stats with nothing counted yet.
+ *
+ * input
+ * ~~~~~
+ * st: pointer to Stats struct
+ *
+ * returns: status
+ **/
+int createS(Stats* st) {
+    memset(st, 0, sizeof(Stats));
+    st->frontier[0] = st->frontier[1] = NULL;
+    st->start = seconds();
+    return true;
+}
+
+/**
+ * Function: levelS()
+ * ~~~~~~~~~~~~~~~~~~
+ * Records the size of a level about to be expanded.
+ *
+ * inputs
+ * ~~~~~~
+ * st: pointer to Stats
+ * a: side (0 for INITIAL, 1 for GOAL)
+ * depth: depth of the level
+ * count: number of configurations on it
+ *
+ * returns: status
+ **/
+int levelS(Stats* st, int a, int depth, long count) {
+    if (depth >= st->nLevel[a]) {
+        long* frontier = realloc(st->frontier[a], sizeof(long) * (depth + 1));
+        if (frontier == NULL) {
+            return false;
+        }
+        for (int i = st->nLevel[a]; i <= depth; i++) {
+            frontier[i] = 0;
+        }
+        st->frontier[a] = frontier;
+        st->nLevel[a] = depth + 1;
+    }
+    st->frontier[a][depth] += count;
+    return true;
+}
+
+/**
+ * Function: tableS()
+ * ~~~~~~~~~~~~~~~~~~
+ * Records the probe lengths of a table, if it is the largest so far.
+ *
+ * inputs
+ * ~~~~~~
+ * st: pointer to Stats
+ * dict: Hashtable
+ *
+ * returns: nothing
+ **/
+void tableS(Stats* st, Hashtable dict) {
+    if (dict.table->count < st->entries) {
+        return;
+    }
+    st->entries = dict.table->count;
+    st->slots = dict.table->size;
+    probesH(dict, st->probes, NPROBES);
+}
+
+/**
+ * Function: reportS()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Writes everything recorded, along with the nodes expanded per second 
+ * since the Stats were created and the peak resident memory.
+ *
+ * inputs
+ * ~~~~~~
+ * st: pointer to Stats
+ * out: file to write to
+ * json: true for a JSON object, false for text
+ *
+ * returns: nothing
+ **/
+void reportS(Stats* st, FILE* out, int json) {
+    static char* name[2] = {"initial", "goal"};
+    double elapsed = seconds() - st->start;
+    long expanded = st->expanded[0] + st->expanded[1];
+    double rate = (elapsed > 0) ? expanded / elapsed : 0;
+    double load = (st->slots > 0) ? (double) st->entries / st->slots : 0;
+    if (!json) {
+        fprintf(out, "pancake: %-8s %12s %12s %12s\n", "side", "expanded", 
+                "generated", "duplicates");
+        for (int a = 0; a < 2; a++) {
+            fprintf(out, "pancake: %-8s %12ld %12ld %12ld\n", name[a], 
+                    st->expanded[a], st->generated[a], st->duplicates[a]);
+        }
+        fprintf(out, "pancake: %.0f nodes/sec (%ld in %.3fs)\n", rate, 
+                expanded, elapsed);
+        for (int a = 0; a < 2; a++) {
+            fprintf(out, "pancake: frontier %s:", name[a]);
+            for (int i = 0; i < st->nLevel[a]; i++) {
+                fprintf(out, " %ld", st->frontier[a][i]);
+            }
+            fprintf(out, "\n");
+        }
+        fprintf(out, "pancake: table %ld entries in %ld slots, load %.2f\n",
+                st->entries, st->slots, load);
+        fprintf(out, "pancake: probe lengths");
+        for (int i = 0; i < NPROBES; i++) {
+            fprintf(out, " %d%s:%ld", i, (i == NPROBES - 1) ? "+" : "", 
+                    st->probes[i]);
+        }
+        fprintf(out, "\npancake: getBatch %.3fs, lookup %.3fs, merge %.3fs\n",
+                st->batch, st->lookup, st->merge);
+        fprintf(out, "pancake: peak memory %ld KB\n", peakKB());
+        return;
+    }
+    fprintf(out, "{\"expanded\": [%ld, %ld], \"generated\": [%ld, %ld], "
+            "\"duplicates\": [%ld, %ld], ", st->expanded[0], st->expanded[1], 
+            st->generated[0], st->generated[1], st->duplicates[0], 
+            st->duplicates[1]);
+    fprintf(out, "\"elapsed\": %.6f, \"nodesPerSec\": %.0f, \"frontier\": [", 
+            elapsed, rate);
+    for (int a = 0; a < 2; a++) {
+        fprintf(out, "%s[", (a > 0) ? ", " : "");
+        for (int i = 0; i < st->nLevel[a]; i++) {
+            fprintf(out, "%s%ld", (i > 0) ? ", " : "", st->frontier[a][i]);
+        }
+        fprintf(out, "]");
+    }
+    fprintf(out, "], \"table\": {\"entries\": %ld, \"slots\": %ld, "
+            "\"load\": %.4f, \"probes\": [", st->entries, st->slots, load);
+    for (int i = 0; i < NPROBES; i++) {
+        fprintf(out, "%s%ld", (i > 0) ? ", " : "", st->probes[i]);
+    }
+    fprintf(out, "]}, \"seconds\": {\"getBatch\": %.6f, \"lookup\": %.6f, "
+            "\"merge\": %.6f}, \"peakKB\": %ld}\n", st->batch, st->lookup, 
+            st->merge, peakKB());
+}
+
+/**
+ * Function: destroyS()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Frees all memory associated with Stats.
+ *
+ * input
+ * ~~~~~
+ * st: pointer to Stats
+ *
+ * returns: status
+ **/
+int destroyS(Stats* st) {
+    free(st->frontier[0]);
+    free(st->frontier[1]);
+    st->frontier[0] = st->frontier[1] = NULL;
+    st->nLevel[0] = st->nLevel[1] = 0;
+    return true;
+}
+
+/**
+ * Function: peakKB()
+ * ~~~~~~~~~~~~~~~~~~
+ * returns: largest resident memory of the process so far, in kilobytes
+ **/
+static long peakKB(void) {
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) < 0) {
+        return 0;
+    }
+    return ru.ru_maxrss;
+}
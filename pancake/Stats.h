@@ -0,0 +1,75 @@
+/**
+ * Stats.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for the counts and timings reported by pancake -stats.
+ *
+ **/
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include "Hashtable.h"
+
+// Number of probe lengths counted apart (longer ones go in the last)
+#define NPROBES 16
+
+/**
+ * Struct: Stats
+ * ~~~~~~~~~~~~~
+ * Totals over every BFS level expanded, with one count per side (0 for 
+ * INITIAL, 1 for GOAL).  A neighbor is a duplicate if it had already 
+ * been reached from the same side, or from the other side too far away 
+ * to make a path.
+ *
+ * members
+ * ~~~~~~~
+ * double start:        time the Stats were created
+ * long expanded[]:     configurations whose neighbors were generated
+ * long generated[]:    neighbors generated
+ * long duplicates[]:   neighbors that had already been reached
+ * double batch:        seconds spent in getBatch() (flips and hashes), 
+ *                      summed over threads
+ * double lookup:       seconds spent looking neighbors up in the table, 
+ *                      summed over threads
+ * double merge:        seconds spent adding new configurations to the 
+ *                      table and the next Frontier
+ * long* frontier[]:    size of every level expanded, by depth (summed 
+ *                      over queries in batch mode)
+ * int nLevel[]:        number of depths in frontier
+ * long entries, slots: size of the largest table recorded
+ * long probes[]:       number of its entries at each distance from the 
+ *                      slot they hash to
+ **/
+typedef struct Stats {
+    double start;
+    long expanded[2];
+    long generated[2];
+    long duplicates[2];
+    double batch;
+    double lookup;
+    double merge;
+    long* frontier[2];
+    int nLevel[2];
+    long entries;
+    long slots;
+    long probes[NPROBES];
+} Stats;
+
+/* See Stats.c for full explanations */
+int createS(Stats* st);
+
+int levelS(Stats* st, int a, int depth, long count);
+
+void tableS(Stats* st, Hashtable dict);
+
+void reportS(Stats* st, FILE* out, int json);
+
+int destroyS(Stats* st);
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ * Zobrist.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Implementation of Zobrist hashing.  Every configuration a search 
+ * generates is one flip away from the one being expanded, so once that 
+ * one is hashed, the hash of each of its neighbors is found by touching 
+ * only the cells of the flipped block instead of the whole 
+ * configuration.
+ *
+ * Only the neighbors are hashed incrementally.  Nodes do not keep their 
+ * hashes (see Nodes.h), so the configuration being expanded is hashed 
+ * from scratch with keyZ(), once for all of its neighbors, and so is 
+ * the image of a neighbor under a Mirror.  Both cost a few percent of 
+ * a BFS at most.
+ *
+ **/
+#include "Zobrist.h"
+
+// Seed of the codes, fixed so that runs are reproducible
+#define SEED 0x2545F4914F6CDD1DUL
+
+static unsigned long nextCode(unsigned long* state);
+
+/**
+ * Function: createZ()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Draws the codes for configurations packed with pk.
+ *
+ * inputs
+ * ~~~~~~
+ * z: pointer to Zobrist struct
+ * pk: pointer to Packing of the configurations
+ *
+ * returns: status
+ **/
+int createZ(Zobrist* z, Packing* pk) {
+    z->pk = pk;
+    z->code = malloc(sizeof(unsigned long) * pk->n * pk->nSymbols);
+    if (z->code == NULL) {
+        return false;
+    }
+    unsigned long state = SEED;
+    for (int i = 0; i < pk->n * pk->nSymbols; i++) {
+        z->code[i] = nextCode(&state);
+    }
+    return true;
+}
+
+/**
+ * Function: hashZ()
+ * ~~~~~~~~~~~~~~~~~
+ * Hashes an unpacked configuration from scratch.
+ *
+ * inputs
+ * ~~~~~~
+ * z: pointer to Zobrist struct
+ * cells: symbol indices of the configuration
+ *
+ * returns: hash value
+ **/
+unsigned long hashZ(Zobrist* z, unsigned char* cells) {
+    int nSymbols = z->pk->nSymbols;
+    unsigned long hash = 0;
+    for (int i = 0; i < z->pk->n; i++) {
+        hash ^= z->code[i * nSymbols + cells[i]];
+    }
+    return hash;
+}
+
+/**
+ * Function: keyZ()
+ * ~~~~~~~~~~~~~~~~
+ * Hashes a packed configuration from scratch.
+ *
+ * inputs
+ * ~~~~~~
+ * z: pointer to Zobrist struct
+ * key: packed configuration
+ *
+ * returns: hash value
+ **/
+unsigned long keyZ(Zobrist* z, Word* key) {
+    unsigned char cells[z->pk->n];
+    unpackP(z->pk, key, cells);
+    return hashZ(z, cells);
+}
+
+/**
+ * Function: flipZ()
+ * ~~~~~~~~~~~~~~~~~
+ * Hash of a configuration produced by flipping the fw x fh block in the 
+ * upper left corner of another.  Only cells of the block are examined.
+ *
+ * inputs
+ * ~~~~~~
+ * z: pointer to Zobrist struct
+ * hash: hash of old
+ * old: symbol indices of the configuration flipped
+ * new: symbol indices of the result
+ * w: width of the pancake
+ * fw, fh: dimensions of the flip
+ *
+ * returns: hash value of new
+ **/
+unsigned long flipZ(Zobrist* z, unsigned long hash, unsigned char* old, 
+        unsigned char* new, int w, int fw, int fh) {
+    int nSymbols = z->pk->nSymbols;
+    for (int r = 0; r < fh; r++) {
+        for (int i = r * w; i < r * w + fw; i++) {
+            if (old[i] != new[i]) {
+                hash ^= z->code[i * nSymbols + old[i]] 
+                        ^ z->code[i * nSymbols + new[i]];
+            }
+        }
+    }
+    return hash;
+}
+
+/**
+ * Function: destroyZ()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Frees all memory associated with a Zobrist struct.
+ *
+ * input
+ * ~~~~~
+ * z: pointer to Zobrist struct
+ *
+ * returns: status
+ **/
+int destroyZ(Zobrist* z) {
+    free(z->code);
+    z->code = NULL;
+    return true;
+}
+
+/**
+ * Function: nextCode()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * splitmix64 generator: advances state and returns its next output.
+ *
+ * input
+ * ~~~~~
+ * state: pointer to generator state
+ *
+ * returns: 64 random bits
+ **/
+static unsigned long nextCode(unsigned long* state) {
+    unsigned long x = (*state += 0x9E3779B97F4A7C15UL);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+    return x ^ (x >> 31);
+}
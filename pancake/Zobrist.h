@@ -0,0 +1,47 @@
+/**
+ * Zobrist.h
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * Header file for Zobrist hashing of configurations.
+ *
+ **/
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "Packing.h"
+
+/**
+ * Struct: Zobrist
+ * ~~~~~~~~~~~~~~~
+ * A random code for every (cell, symbol) pair.  The hash of a
+ * configuration is the exclusive or of the codes of its cells, so a
+ * flip changes it by the codes of the cells in the flipped block only.
+ *
+ * members
+ * ~~~~~~~
+ * Packing* pk:         packing of the configurations hashed
+ * unsigned long* code: n * nSymbols codes, code[cell * nSymbols + symbol]
+ **/
+typedef struct Zobrist {
+    Packing* pk;
+    unsigned long* code;
+} Zobrist;
+
+/* See Zobrist.c for full explanations */
+int createZ(Zobrist* z, Packing* pk);
+
+unsigned long hashZ(Zobrist* z, unsigned char* cells);
+
+unsigned long keyZ(Zobrist* z, Word* key);
+
+unsigned long flipZ(Zobrist* z, unsigned long hash, unsigned char* old, 
+        unsigned char* new, int w, int fw, int fh);
+
+int destroyZ(Zobrist* z);
+
+#endif
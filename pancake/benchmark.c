@@ -0,0 +1,310 @@
+/**
+ * benchmark.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * benchmark runs pancake on a fixed catalog of boards, from 2x2 to 4x4,
+ * with distinct and repeated symbols and with short and long
+ * MAX_LENGTHs.  The INITIAL and GOAL of every instance come from a
+ * seeded generator, so the same SEED gives the same instances on every
+ * commit.  Each instance is run REPEAT times and the median wall and
+ * CPU times are kept, along with the states expanded (from pancake
+ * -stats json) and the peak resident memory.  The report is a JSON
+ * object on standard output.
+ *
+ **/
+#define _DEFAULT_SOURCE
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define die(msg)    exit (fprintf (stderr, "%s\n", msg))
+#define USAGE "benchmark: benchmark [-s SEED] [-r REPEAT] PANCAKE"
+// Base 10 integers should be returned from strtol()
+#define BASE 10
+// Default seed and number of runs of every instance
+#define SEED 223
+#define REPEAT 3
+// Most runs of one instance
+#define MAXREPEAT 99
+// Longest output of pancake read back (paths are at most 4x4 cells)
+#define OUTSIZE 65536
+
+/**
+ * Struct: Board
+ * ~~~~~~~~~~~~~
+ * One entry of the catalog.
+ *
+ * members
+ * ~~~~~~~
+ * char* name:      name in the report
+ * int height, width:   dimensions of the pancake
+ * char* symbols:   multiset of the cells
+ * int maxlen:      MAX_LENGTH
+ * int pairs:       number of INITIAL GOAL pairs drawn for it
+ **/
+typedef struct Board {
+    char* name;
+    int height;
+    int width;
+    char* symbols;
+    int maxlen;
+    int pairs;
+} Board;
+
+/**
+ * Struct: Run
+ * ~~~~~~~~~~~
+ * What one run of pancake took.
+ *
+ * members
+ * ~~~~~~~
+ * double wall:     seconds elapsed
+ * double cpu:      user and system CPU seconds
+ * long expanded:   configurations expanded, both sides
+ * long peakKB:     peak resident memory
+ * int flips:       flips in the path found (-1 for none)
+ **/
+typedef struct Run {
+    double wall;
+    double cpu;
+    long expanded;
+    long peakKB;
+    int flips;
+} Run;
+
+static Board catalog[] = {
+    {"2x2-distinct-deep", 2, 2, "abcd", 20, 3},
+    {"2x2-repeated-deep", 2, 2, "aabb", 20, 3},
+    {"2x3-distinct-deep", 2, 3, "abcdef", 20, 3},
+    {"2x3-repeated-deep", 2, 3, "aabbcc", 20, 3},
+    {"3x3-distinct-shallow", 3, 3, "abcdefghi", 4, 3},
+    {"3x3-distinct-deep", 3, 3, "abcdefghi", 30, 3},
+    {"3x3-repeated-deep", 3, 3, "aaabbbccc", 30, 3},
+    {"3x4-distinct-shallow", 3, 4, "abcdefghijkl", 5, 3},
+    {"3x4-distinct-deep", 3, 4, "abcdefghijkl", 30, 2},
+    {"3x4-repeated-deep", 3, 4, "aaabbbcccddd", 30, 3},
+    {"4x4-distinct-shallow", 4, 4, "abcdefghijklmnop", 6, 2},
+    {"4x4-distinct-medium", 4, 4, "abcdefghijklmnop", 8, 2},
+    {"4x4-repeated-shallow", 4, 4, "aaaabbbbccccdddd", 6, 2},
+    {"4x4-repeated-deep", 4, 4, "aaaabbbbccddeeff", 30, 3},
+};
+
+int runPancake(char* pancake, Board* b, char* initial, char* goal, Run* r);
+void shuffle(char* cells, int n, unsigned long* state);
+unsigned long nextRandom(unsigned long* state);
+int compareDoubles(const void* a, const void* b);
+
+int main(int argc, char* argv[]) {
+    int curArg = 1;
+    char* endptr;
+    unsigned long seed = SEED;
+    int repeat = REPEAT;
+    while (curArg + 1 < argc && argv[curArg][0] == '-') {
+        if (!strcmp(argv[curArg], "-s")) {
+            seed = strtoul(argv[curArg + 1], &endptr, BASE);
+        } else if (!strcmp(argv[curArg], "-r")) {
+            repeat = strtol(argv[curArg + 1], &endptr, BASE);
+            if (repeat < 1 || repeat > MAXREPEAT) {
+                die("benchmark: Invalid REPEAT");
+            }
+        } else {
+            die(USAGE);
+        }
+        if (*endptr != '\0') {
+            die(USAGE);
+        }
+        curArg += 2;
+    }
+    if (curArg + 1 != argc) {
+        die(USAGE);
+    }
+    char* pancake = argv[curArg];
+
+    printf("{\"pancake\": \"%s\", \"seed\": %lu, \"repeat\": %d, "
+            "\"instances\": [", pancake, seed, repeat);
+    unsigned long state = seed;
+    double totalWall = 0;
+    long totalExpanded = 0;
+    int first = true;
+    for (int i = 0; i < sizeof(catalog) / sizeof(Board); i++) {
+        Board* b = &catalog[i];
+        int n = b->height * b->width;
+        for (int p = 0; p < b->pairs; p++) {
+            char initial[n + 1];
+            char goal[n + 1];
+            strcpy(goal, b->symbols);
+            shuffle(goal, n, &state);
+            strcpy(initial, b->symbols);
+            shuffle(initial, n, &state);
+            Run runs[repeat];
+            double wall[repeat];
+            double cpu[repeat];
+            for (int k = 0; k < repeat; k++) {
+                if (!runPancake(pancake, b, initial, goal, &runs[k])) {
+                    die("benchmark: cannot run PANCAKE");
+                }
+                wall[k] = runs[k].wall;
+                cpu[k] = runs[k].cpu;
+            }
+            qsort(wall, repeat, sizeof(double), compareDoubles);
+            qsort(cpu, repeat, sizeof(double), compareDoubles);
+            Run* r = &runs[0];
+            printf("%s\n  {\"name\": \"%s\", \"height\": %d, \"width\": %d, "
+                    "\"maxlen\": %d, \"initial\": \"%s\", \"goal\": \"%s\", "
+                    "\"flips\": %d, \"wall\": %.6f, \"cpu\": %.6f, "
+                    "\"expanded\": %ld, \"peakKB\": %ld}",
+                    first ? "" : ",", b->name, b->height, b->width,
+                    b->maxlen, initial, goal, r->flips, wall[repeat / 2],
+                    cpu[repeat / 2], r->expanded, r->peakKB);
+            fflush(stdout);
+            first = false;
+            totalWall += wall[repeat / 2];
+            totalExpanded += r->expanded;
+        }
+    }
+    printf("\n], \"total\": {\"wall\": %.6f, \"expanded\": %ld}}\n",
+            totalWall, totalExpanded);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Function: runPancake()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * Runs pancake -stats json on one pair, with its output going to
+ * temporary files that are read back once it exits.
+ *
+ * inputs
+ * ~~~~~~
+ * pancake: path of the pancake program
+ * b: pointer to Board
+ * initial, goal: INITIAL and GOAL
+ * r: pointer to Run to fill
+ *
+ * returns: status (false if pancake could not be run or failed)
+ **/
+int runPancake(char* pancake, Board* b, char* initial, char* goal, Run* r) {
+    char height[16];
+    char width[16];
+    char maxlen[16];
+    snprintf(height, sizeof(height), "%d", b->height);
+    snprintf(width, sizeof(width), "%d", b->width);
+    snprintf(maxlen, sizeof(maxlen), "%d", b->maxlen);
+    FILE* out = tmpfile();
+    FILE* err = tmpfile();
+    if (out == NULL || err == NULL) {
+        return false;
+    }
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(fileno(out), STDOUT_FILENO);
+        dup2(fileno(err), STDERR_FILENO);
+        execl(pancake, pancake, "-stats", "json", height, width, maxlen,
+                initial, goal, (char*) NULL);
+        _exit(127);
+    }
+    int status;
+    struct rusage ru;
+    if (pid < 0 || wait4(pid, &status, 0, &ru) < 0) {
+        return false;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    r->wall = (end.tv_sec - start.tv_sec)
+            + (end.tv_nsec - start.tv_nsec) / 1e9;
+    r->cpu = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6
+            + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+    r->peakKB = ru.ru_maxrss;
+
+    // The path is printed one configuration per line
+    char buffer[OUTSIZE];
+    rewind(out);
+    int lines = 0;
+    while (fgets(buffer, OUTSIZE, out) != NULL) {
+        lines++;
+    }
+    r->flips = lines - 1;
+    rewind(err);
+    size_t length = fread(buffer, 1, OUTSIZE - 1, err);
+    buffer[length] = '\0';
+    long expanded[2] = {0, 0};
+    char* field = strstr(buffer, "\"expanded\": [");
+    if (field != NULL) {
+        sscanf(field, "\"expanded\": [%ld, %ld]", &expanded[0],
+                &expanded[1]);
+    }
+    r->expanded = expanded[0] + expanded[1];
+    fclose(out);
+    fclose(err);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * Function: shuffle()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Puts the cells of a configuration in a random order.
+ *
+ * inputs
+ * ~~~~~~
+ * cells: the cells
+ * n: number of cells
+ * state: state of the generator
+ *
+ * returns: nothing
+ **/
+void shuffle(char* cells, int n, unsigned long* state) {
+    for (int i = n - 1; i > 0; i--) {
+        int j = nextRandom(state) % (i + 1);
+        char swap = cells[i];
+        cells[i] = cells[j];
+        cells[j] = swap;
+    }
+}
+
+/**
+ * Function: nextRandom()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * splitmix64 generator, as in Zobrist.c, which gives the same numbers 
+ * on every platform (unlike rand()).
+ *
+ * input
+ * ~~~~~
+ * state: state of the generator
+ *
+ * returns: next number
+ **/
+unsigned long nextRandom(unsigned long* state) {
+    unsigned long x = (*state += 0x9E3779B97F4A7C15UL);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Function: compareDoubles()
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Orders doubles for qsort().
+ *
+ * inputs
+ * ~~~~~~
+ * a, b: pointers to the doubles
+ *
+ * returns: negative, zero or positive as a is below, equal to or above b
+ **/
+int compareDoubles(const void* a, const void* b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return (x > y) - (x < y);
+}
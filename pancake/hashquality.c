@@ -0,0 +1,349 @@
+/**
+ * hashquality.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * hashquality measures how well hash functions spread the configurations
+ * a BFS actually visits.  For every board of a fixed catalog, it
+ * collects up to LIMIT configurations by BFS from a sorted GOAL and
+ * hashes all of them with each of
+ *
+ *  - eisenstat: the byte-at-a-time string hash pancake started out with,
+ *    run over the bytes of the packed keys;
+ *  - eisenword: the same hash a Word at a time, which Hashtable used on
+ *    packed keys before hashH();
+ *  - word:      hashH() from Hashtable.c;
+ *  - zobrist:   keyZ(), the hash pancake's search table uses;
+ *  - zobmix:    keyZ() through SLOTMIX(), which is what Hashtable now
+ *    picks slots by.
+ *
+ * For each it reports the time per key, the distribution of chain
+ * lengths with as many chains as keys (a random hash gives a Poisson
+ * distribution of mean 1, and a chi-square per chain near 1), and the
+ * probe lengths of linear probing at the load a Hashtable reaches
+ * just before it grows.  Chains and slots are picked from the high bits
+ * of the hash, as Hashtable does.
+ *
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "Flip.h"
+#include "Hashtable.h"
+#include "Packing.h"
+#include "Zobrist.h"
+
+#define die(msg)    exit (fprintf (stderr, "%s\n", msg))
+#define USAGE "hashquality: hashquality [-n LIMIT]"
+// Base 10 integers should be returned from strtol()
+#define BASE 10
+// Default number of configurations collected per board
+#define LIMIT (1L << 20)
+// Chain lengths counted one by one, the rest together
+#define MAXCHAIN 8
+// Hash functions compared
+#define EISENSTAT 0
+#define EISENWORD 1
+#define WORD 2
+#define ZOBRIST 3
+#define ZOBMIX 4
+#define NHASHES 5
+
+/**
+ * Struct: Board
+ * ~~~~~~~~~~~~~
+ * One entry of the catalog.
+ *
+ * members
+ * ~~~~~~~
+ * char* name:      name in the report
+ * int height, width:   dimensions of the pancake
+ * char* goal:      GOAL, from which the configurations are reached
+ **/
+typedef struct Board {
+    char* name;
+    int height;
+    int width;
+    char* goal;
+} Board;
+
+static Board catalog[] = {
+    {"3x3-distinct", 3, 3, "abcdefghi"},
+    {"3x4-distinct", 3, 4, "abcdefghijkl"},
+    {"4x4-distinct", 4, 4, "abcdefghijklmnop"},
+    {"4x4-repeated", 4, 4, "aaaabbbbccddeeff"},
+    {"4x4-binary", 4, 4, "aaaaaaaabbbbbbbb"},
+    {"4x4-three", 4, 4, "aaaaaabbbbbccccc"},
+    {"5x5-distinct", 5, 5, "abcdefghijklmnopqrstuvwxy"},
+};
+
+static char* names[NHASHES] = {"eisenstat", "eisenword", "word", "zobrist",
+        "zobmix"};
+
+long collect(Board* b, Packing* pk, Zobrist* z, long limit, Word* keys);
+void report(char* name, unsigned long* hashes, long count, double ns);
+unsigned long eisenstat(Word* key, int width);
+unsigned long eisenword(Word* key, int width);
+double seconds(void);
+
+int main(int argc, char* argv[]) {
+    long limit = LIMIT;
+    char* endptr;
+    if (argc == 3 && !strcmp(argv[1], "-n")) {
+        limit = strtol(argv[2], &endptr, BASE);
+        if (*endptr != '\0' || limit < 1) {
+            die(USAGE);
+        }
+    } else if (argc != 1) {
+        die(USAGE);
+    }
+    for (int i = 0; i < sizeof(catalog) / sizeof(Board); i++) {
+        Board* b = &catalog[i];
+        Packing pk;
+        Zobrist z;
+        createP(&pk, b->goal, b->height * b->width);
+        Word* keys = malloc(sizeof(Word) * pk.width * limit);
+        unsigned long* hashes = malloc(sizeof(unsigned long) * limit);
+        if (keys == NULL || hashes == NULL || !createZ(&z, &pk)) {
+            die("hashquality: out of memory");
+        }
+        long count = collect(b, &pk, &z, limit, keys);
+        printf("%s: %ld configurations, %d Word(s) each\n", b->name, count,
+                pk.width);
+        for (int f = 0; f < NHASHES; f++) {
+            double start = seconds();
+            for (long k = 0; k < count; k++) {
+                Word* key = keys + k * pk.width;
+                hashes[k] = (f == EISENSTAT) ? eisenstat(key, pk.width)
+                        : (f == EISENWORD) ? eisenword(key, pk.width)
+                        : (f == WORD) ? hashH(key, pk.width)
+                        : (f == ZOBRIST) ? keyZ(&z, key)
+                        : SLOTMIX(keyZ(&z, key));
+            }
+            double ns = (seconds() - start) * 1e9 / count;
+            report(names[f], hashes, count, ns);
+        }
+        printf("\n");
+        fflush(stdout);
+        destroyZ(&z);
+        free(keys);
+        free(hashes);
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Function: collect()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Gathers configurations of a board in BFS order from GOAL, the way
+ * pancake's search tables fill up.
+ *
+ * inputs
+ * ~~~~~~
+ * b: pointer to Board
+ * pk: Packing of the board
+ * z: Zobrist codes of the board (to find duplicates with)
+ * limit: most configurations gathered
+ * keys: room for limit packed keys
+ *
+ * returns: number of configurations gathered
+ **/
+long collect(Board* b, Packing* pk, Zobrist* z, long limit, Word* keys) {
+    int width = pk->width;
+    int nStep = countMoves(b->width, b->height);
+    Word batch[(nStep + 1) * width];
+    unsigned long codes[nStep + 1];
+    Hashtable seen;
+    if (!createH(&seen, limit, width, z)) {
+        die("hashquality: out of memory");
+    }
+    encodeP(pk, b->goal, keys);
+    addH(seen, keys, 0);
+    long count = 1;
+    // keys is also the queue: the next configuration to expand is at
+    // head
+    for (long head = 0; head < count && count < limit; head++) {
+        Word* config = keys + head * width;
+        getBatch(pk, config, b->width, b->height, batch, z, keyZ(z, config),
+                codes);
+        for (int j = 0; j < nStep && count < limit; j++) {
+            Word* key = keys + count * width;
+            memcpy(key, batch + j * width, sizeof(Word) * width);
+            if (retrieveHashH(seen, key, codes[j]) == MISSING) {
+                addHashH(seen, key, codes[j], count);
+                count++;
+            }
+        }
+    }
+    destroyH(seen);
+    return count;
+}
+
+/**
+ * Function: report()
+ * ~~~~~~~~~~~~~~~~~~
+ * Prints the time, chain lengths and probe lengths of one hash function
+ * over a set of keys.
+ *
+ * inputs
+ * ~~~~~~
+ * name: name of the hash function
+ * hashes: hash of every key
+ * count: number of keys
+ * ns: nanoseconds per key hashed
+ *
+ * returns: nothing
+ **/
+void report(char* name, unsigned long* hashes, long count, double ns) {
+    // As many chains as keys, rounded to a power of two
+    int bits = 0;
+    while ((1L << bits) < count) {
+        bits++;
+    }
+    long nChains = 1L << bits;
+    long* chain = calloc(nChains, sizeof(long));
+    if (chain == NULL) {
+        die("hashquality: out of memory");
+    }
+    for (long k = 0; k < count; k++) {
+        chain[(bits > 0) ? hashes[k] >> (64 - bits) : 0]++;
+    }
+    long histogram[MAXCHAIN + 1] = {0};
+    long longest = 0;
+    double mean = (double) count / nChains;
+    double chi = 0;
+    for (long c = 0; c < nChains; c++) {
+        histogram[(chain[c] < MAXCHAIN) ? chain[c] : MAXCHAIN]++;
+        longest = (chain[c] > longest) ? chain[c] : longest;
+        chi += (chain[c] - mean) * (chain[c] - mean) / mean;
+    }
+    free(chain);
+
+    // Linear probing in a table three quarters full, as a Hashtable is
+    // just before it grows
+    int tBits = 0;
+    while ((1L << tBits) * 3 / 4 < count) {
+        tBits++;
+    }
+    long size = 1L << tBits;
+    char* used = calloc(size, 1);
+    long* probes = malloc(sizeof(long) * count);
+    if (used == NULL || probes == NULL) {
+        die("hashquality: out of memory");
+    }
+    double total = 0;
+    for (long k = 0; k < count; k++) {
+        long i = (tBits > 0) ? hashes[k] >> (64 - tBits) : 0;
+        long p = 0;
+        while (used[i]) {
+            i = (i + 1) & (size - 1);
+            p++;
+        }
+        used[i] = true;
+        probes[k] = p;
+        total += p;
+    }
+    // The 99th percentile by counting, as probes are small integers
+    long worst = 0;
+    for (long k = 0; k < count; k++) {
+        worst = (probes[k] > worst) ? probes[k] : worst;
+    }
+    long* byLength = calloc(worst + 1, sizeof(long));
+    if (byLength == NULL) {
+        die("hashquality: out of memory");
+    }
+    for (long k = 0; k < count; k++) {
+        byLength[probes[k]]++;
+    }
+    long p99 = 0;
+    for (long below = 0; p99 <= worst; p99++) {
+        below += byLength[p99];
+        if (below * 100 >= count * 99) {
+            break;
+        }
+    }
+    free(byLength);
+    free(probes);
+    free(used);
+
+    printf("  %-9s %6.1f ns/key  chains", name, ns);
+    for (int c = 0; c <= MAXCHAIN; c++) {
+        printf(" %s%d:%ld", (c == MAXCHAIN) ? "+" : "", c, histogram[c]);
+    }
+    printf("  longest %ld  chi2/chain %.3f\n", longest, chi / nChains);
+    printf("  %-9s %6s          probes at load %.2f: mean %.2f  p99 %ld  "
+            "max %ld\n", "", "", (double) count / size, total / count, p99,
+            worst);
+}
+
+/**
+ * Function: eisenstat()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * The string hash by Stanley C. Eisenstat <stanley.eisenstat@yale.edu>
+ * that pancake first hashed configurations with, over the bytes of a
+ * packed key.  The table took it modulo its size; here, like the 
+ * others, it is indexed by its high bits.
+ *
+ * inputs
+ * ~~~~~~
+ * key: packed key
+ * width: number of Words in key
+ *
+ * returns: hash value
+ **/
+unsigned long eisenstat(Word* key, int width) {
+    unsigned long sum;
+    int shift;
+    const unsigned long prime = 3141592653589793239L;
+    unsigned char* s = (unsigned char*) key;
+    size_t n = sizeof(Word) * width;
+    for (sum = 0, shift = 0; n > 0; s++, n--) {
+        sum ^= (unsigned long) *s << shift;
+        shift += 7;
+        if (shift >= 57) {
+            shift -= 57;
+        }
+    }
+    return (prime * sum);
+}
+
+/**
+ * Function: eisenword()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * eisenstat() adapted to consume a whole Word per iteration, as 
+ * Hashtable hashed packed keys before hashH().
+ *
+ * inputs
+ * ~~~~~~
+ * key: packed key
+ * width: number of Words in key
+ *
+ * returns: hash value
+ **/
+unsigned long eisenword(Word* key, int width) {
+    unsigned long sum;
+    const unsigned long prime = 3141592653589793239L;
+    for (sum = 0; width > 0; key++, width--) {
+        sum = (sum ^ *key) * prime;
+        sum ^= sum >> 29;
+    }
+    return (prime * sum);
+}
+
+/**
+ * Function: seconds()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Reads a monotonic clock.
+ *
+ * returns: time in seconds since an arbitrary starting point
+ **/
+double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,149 @@
+/**
+ * mkpdb.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * mkpdb builds a pattern database for pancake.  The characters of
+ * PATTERN stay distinct and every other character of GOAL becomes a
+ * blank; a breadth-first search from the abstraction of GOAL records
+ * how many flips every abstract configuration is from it, and the
+ * table is written to FILE for pancake -pdb FILE to map.
+ *
+ **/
+#include <stdio.h>
+#include <string.h>
+#include "Database.h"
+#include "Flip.h"
+
+#define die(msg)    exit (fprintf (stderr, "%s\n", msg))
+#define USAGE "mkpdb: mkpdb [HEIGHT WIDTH] GOAL PATTERN FILE"
+// Base 10 integers should be returned from strtol()
+#define BASE 10
+// Minimum and maximum pancake dimensions
+#define MINWH 1
+#define MAXWH 16
+
+int buildTable(Database* d, unsigned char* goal, int w, int h);
+
+int main(int argc, char* argv[]) {
+    if (argc != 4 && argc != 6) {
+        die(USAGE);
+    }
+    int curArg = 1;
+    int height = 3;
+    int width = 3;
+    char* endptr;
+    // If width and length are supplied, parse them
+    if (argc == 6) {
+        if ((height = strtol(argv[curArg++], &endptr, BASE)) < MINWH ||
+                height > MAXWH || *endptr != '\0') {
+            die("mkpdb: Invalid HEIGHT");
+        }
+        if ((width = strtol(argv[curArg++], &endptr, BASE)) < MINWH ||
+                width > MAXWH || *endptr != '\0') {
+            die("mkpdb: Invalid WIDTH");
+        }
+    }
+    int n = height * width;
+    char* goal = argv[curArg++];
+    char* pattern = argv[curArg++];
+    char* file = argv[curArg];
+    if (strlen(goal) != n) {
+        die("mkpdb: strlen(GOAL) != HEIGHT*WIDTH");
+    }
+    // Cells of GOAL outside the pattern become blanks
+    char abstract[n];
+    for (int i = 0; i < n; i++) {
+        abstract[i] = (strchr(pattern, goal[i]) != NULL) ? goal[i] : '\0';
+    }
+    for (int i = 0; pattern[i] != '\0'; i++) {
+        if (strchr(goal, pattern[i]) == NULL) {
+            die("mkpdb: PATTERN has a character not in GOAL");
+        }
+    }
+
+    Packing pk;
+    createP(&pk, goal, n);
+    Database d;
+    if (!createD(&d, &pk, goal, abstract)) {
+        die("mkpdb: PATTERN is too large");
+    }
+    unsigned char cells[n];
+    for (int i = 0; i < n; i++) {
+        cells[i] = pk.index[(unsigned char) goal[i]];
+    }
+    int depth = buildTable(&d, cells, width, height);
+    if (depth < 0) {
+        die("mkpdb: out of memory");
+    }
+    if (!saveD(&d, file, width, height, abstract)) {
+        die("mkpdb: cannot write FILE");
+    }
+    fprintf(stderr, "mkpdb: %llu entries, farthest %d flips\n",
+            (unsigned long long) d.entries, depth);
+    destroyD(&d);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Function: buildTable()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * Fills the table of a Database by breadth-first search from the
+ * abstraction of GOAL.  Every flip is its own inverse, so distances
+ * from GOAL are also distances to GOAL.  The table doubles as the
+ * frontier: level k is every entry holding k, found by scanning the
+ * whole table, so no queue is needed.
+ *
+ * inputs
+ * ~~~~~~
+ * d: pointer to Database (without a table)
+ * goal: symbol indices of GOAL
+ * w, h: dimensions of the pancake
+ *
+ * returns: largest distance in the table, -1 if memory ran out
+ **/
+int buildTable(Database* d, unsigned char* goal, int w, int h) {
+    int nStep = countMoves(w, h);
+    Move* moves = malloc(sizeof(Move) * (nStep + 1));
+    d->dist = malloc(d->entries);
+    if (moves == NULL || d->dist == NULL) {
+        free(moves);
+        return -1;
+    }
+    listMoves(w, h, moves);
+    memset(d->dist, UNSEEN, d->entries);
+    unsigned char cur[d->n];
+    unsigned char next[d->n];
+    abstractD(d, goal, cur);
+    d->dist[rankD(d, cur)] = 0;
+
+    int depth = 0;
+    long added = 1;
+    while (added > 0 && depth + 1 < UNSEEN) {
+        added = 0;
+        for (Word r = 0; r < d->entries; r++) {
+            if (d->dist[r] != depth) {
+                continue;
+            }
+            unrankD(d, r, cur);
+            for (int i = 0; i < nStep; i++) {
+                Move m = moves[i];
+                flipPancake(cur, next, w, h, m.fw, m.fh, m.v);
+                Word q = rankD(d, next);
+                if (d->dist[q] == UNSEEN) {
+                    d->dist[q] = depth + 1;
+                    added++;
+                }
+            }
+        }
+        if (added > 0) {
+            depth++;
+        }
+    }
+    free(moves);
+    return depth;
+}
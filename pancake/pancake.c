@@ -12,13 +12,66 @@
  * there is a possible path of two-dimensional pancake flips from 
  * the INITIAL to the GOAL within MAX_LENGTH steps.
  *
+ * BFS on boards of at most MAXRANKEDN distinct symbols starts out with 
+ * a Hashtable and moves to a few bits per permutation rank (see 
+ * Ranked.c) once that takes less memory.
+ *
+ * With -disk DIR, the levels of the search are kept in files in DIR 
+ * instead of memory, for searches larger than memory.
+ *
+ * With -table FILE, boards of distinct symbols are answered from a 
+ * table of the distances of every configuration, built once and kept 
+ * in FILE.
+ *
+ * With -stats FORMAT, BFS searches report what they did on standard 
+ * error as they exit, as text or json.
+ *
+ * With -batch, INITIAL GOAL pairs are read from standard input, one 
+ * per line, and each path is followed by an empty line.  The part of 
+ * the search grown from GOAL is kept for as long as GOAL stays the same.
+ *
+ * BFS on a square pancake whose GOAL is its own transpose, up to 
+ * relabeling symbols, only keeps one of each configuration and its 
+ * image on GOAL's end (see Mirror.c).
+ *
+ * With -maxmem SIZE, BFS stops adding levels before its table would 
+ * take more than SIZE bytes, and finishes with a depth-first search 
+ * against the levels it already has (see Perimeter.c).
+ *
+ * With -checkpoint FILE, BFS writes what it has found to FILE every 
+ * CKEVERY seconds (or every SECONDS with -every), between levels, and 
+ * with -resume FILE it carries on from such a file instead of starting 
+ * over (see Checkpoint.c).  The file is left behind when the search 
+ * ends.
+ *
  **/
 #include <stdio.h>
 #include <string.h>
+#include "Astar.h"
+#include "Cayley.h"
+#include "Checkpoint.h"
+#include "Disk.h"
+#include "Flip.h"
+#include "Hashset.h"
 #include "Hashtable.h"
-#include "/c/cs223/Hwk4/Queue.h"
+#include "Level.h"
+#include "Mirror.h"
+#include "Nodes.h"
+#include "Perimeter.h"
+#include "Ranked.h"
+#include "Stats.h"
 
 #define die(msg)    exit (fprintf (stderr, "%s\n", msg))
+#define USAGE "pancake: pancake [-j N] [-stats FORMAT] [-maxmem SIZE] " \
+        "[HEIGHT WIDTH] MAXLENGTH INITIAL GOAL\n" \
+        "       pancake [-checkpoint FILE [-every SECONDS]] [-resume FILE] " \
+        "[...] MAXLENGTH INITIAL GOAL\n" \
+        "       pancake [-astar | -idastar] [-pdb FILE] [HEIGHT WIDTH] " \
+        "MAXLENGTH INITIAL GOAL\n" \
+        "       pancake -disk DIR [HEIGHT WIDTH] MAXLENGTH INITIAL GOAL\n" \
+        "       pancake -table FILE [HEIGHT WIDTH] MAXLENGTH INITIAL GOAL\n" \
+        "       pancake -batch [-j N] [-stats FORMAT] [-maxmem SIZE] " \
+        "[HEIGHT WIDTH] MAXLENGTH < PAIRS"
 // Base 10 integers should be returned from strtol()
 #define BASE 10 
 // Minimum and maximum pancake dimensions
@@ -26,8 +79,22 @@
 #define MAXWH 16
 // Minimum MAX_LENGTH
 #define MINLEN 1
-// Size of hashtable (number of chains)
-#define CHAINS 100003
+// Initial number of entries the hashtable is sized for (it grows as needed)
+#define TABLESIZE 1024
+// Maximum number of threads for -j
+#define MAXTHREADS 256
+// Default seconds between checkpoints
+#define CKEVERY 300
+// Search modes: bidirectional BFS (default), -astar, -idastar, -table, 
+// -disk
+#define BFS 0
+#define ASTAR 1
+#define IDASTAR 2
+#define TABLE 3
+#define DISK 4
+// Longest line read in batch mode: two configurations of MAXWH * MAXWH 
+// cells, the blanks around them and the newline
+#define LINESIZE (2 * MAXWH * MAXWH + 8)
 
 /**
  * Struct: Rule
@@ -38,6 +105,17 @@
  * int height:  height of the pancake
  * int width:   width of the pancake
  * int maxlen:  maximum flips allowed from initial to goal
+ * int threads: number of threads expanding each BFS level (-j)
+ * int mode:    BFS, ASTAR, IDASTAR, TABLE or DISK
+ * int batch:   true if pairs are read from standard input (-batch)
+ * char* pdb:   pattern database file for the informed searches (or NULL)
+ * char* table: distance table file for TABLE (or NULL)
+ * char* dir:   directory for the files of DISK (or NULL)
+ * char* stats: format of the -stats report, "text" or "json" (or NULL)
+ * long maxmem: bytes the table of a BFS may take (0 for no limit)
+ * char* checkpoint:    file BFS writes checkpoints to (or NULL)
+ * char* resume:    checkpoint file BFS starts from (or NULL)
+ * int every:   seconds between checkpoints
  * char* initial:   character string of initial configuration
  * char* goal:      character string of desired configuration
  **/
@@ -45,14 +123,92 @@ typedef struct Rule {
     int height;
     int width;
     int maxlen;
+    int threads;
+    int mode;
+    int batch;
+    char* pdb;
+    char* table;
+    char* dir;
+    char* stats;
+    long maxmem;
+    char* checkpoint;
+    char* resume;
+    int every;
     char* initial;
     char* goal;
 } Rule;
 
+/**
+ * Struct: Tree
+ * ~~~~~~~~~~~~
+ * One end of a bidirectional breadth-first search.
+ *
+ * members
+ * ~~~~~~~
+ * Frontier level:  configurations whose neighbors come next
+ * int depth:       number of levels already expanded
+ **/
+typedef struct Tree {
+    Frontier level;
+    int depth;
+} Tree;
+
+/**
+ * Struct: Session
+ * ~~~~~~~~~~~~~~~
+ * Everything that only depends on GOAL, and so can be kept from one 
+ * query to the next.  Apart from the queries in progress, s.dict only 
+ * holds the nodes of tree.
+ *
+ * members
+ * ~~~~~~~
+ * char* goal:      GOAL (a copy)
+ * Packing pk:      packing of configurations
+ * Zobrist z:       codes configurations are hashed with
+ * Mirror mirror:   symmetry of GOAL (used if s.mirror points to it)
+ * Search s:        search parameters and the table of configurations
+ * Nodes nodes:     nodes of tree, GOAL's first
+ * Tree tree:       end of the search grown from GOAL
+ * long maxmem:     bytes the table of a query may take (0 for no limit)
+ * Checkpoint ck:   checkpoints of a query that is not reused
+ * char* resume:    checkpoint file the first query starts from (or NULL)
+ **/
+typedef struct Session {
+    char* goal;
+    Packing pk;
+    Zobrist z;
+    Mirror mirror;
+    Search s;
+    Nodes nodes;
+    Tree tree;
+    long maxmem;
+    Checkpoint ck;
+    char* resume;
+} Session;
+
 int parseArgs(Rule* rule, int argc, char* argv[]);
-int initTriples(Triple* initial, Triple* goal, Rule rule);
-char* flipPancake(char* old, int w, int h, int fw, int fh, int v);
-char** getBatch(char* config, int w, int h);
+long parseSize(char* arg);
+char* checkPair(int n, char* initial, char* goal);
+int openSession(Session* ss, Rule* rule, char* goal, Stats* stats);
+void closeSession(Session* ss);
+int newRoot(Session* ss, Nodes* nd, char* config);
+int query(Session* ss, char* initial, int reuse);
+long rankedLimit(Session* ss);
+long memoryLimit(Session* ss, long bytes);
+int rankedFinish(Session* ss, Tree* side[2]);
+int perimeterFinish(Session* ss, Tree* side[2]);
+int levelSearch(Search* s, Tree* side[2], long* from, long* to, 
+        long limit, long budget, Checkpoint* ck);
+int informedSearch(Session* ss, Rule* rule);
+int tableSearch(Rule* rule);
+int diskQuery(Rule* rule);
+int batchMode(Rule* rule, Stats* stats);
+void printPath(Search* s, long from, long to);
+void printChain(Search* s, Nodes* nd, long last);
+void printTrail(Search* s, long first, Word* actual);
+void alignImage(Search* s, Word* from, Word* config, Word* out);
+void printCells(Packing* pk, unsigned char* cells);
+void printConfig(Packing* pk, Word* config);
 void sort(char** unsorted, char** sorted, int len);
 
 
@@ -60,149 +216,876 @@ int main(int argc, char* argv[]) {
     // Parse command line arguments into a Rule struct 
     Rule rule;
     parseArgs(&rule, argc, argv);
+    Stats st;
+    Stats* stats = NULL;
+    if (rule.stats != NULL && createS(&st)) {
+        stats = &st;
+    }
+    if (rule.batch) {
+        int status = batchMode(&rule, stats);
+        if (stats != NULL) {
+            reportS(stats, stderr, !strcmp(rule.stats, "json"));
+            destroyS(stats);
+        }
+        return status;
+    }
+    if (rule.mode == TABLE) {
+        return tableSearch(&rule);
+    }
+    if (rule.mode == DISK) {
+        return diskQuery(&rule);
+    }
+    Session ss;
+    if (!openSession(&ss, &rule, rule.goal, stats)) {
+        die("pancake: out of memory");
+    }
+
+    double start = seconds();
+    int found;
+    if (rule.mode == BFS) {
+        found = query(&ss, rule.initial, false);
+    } else {
+        found = informedSearch(&ss, &rule);
+    }
+    if (found < 0) {
+        die("pancake: out of memory");
+    }
+    if (rule.threads > 1) {
+        // CPU time the workers and merges used for each second that 
+        // passed; this is not a speedup, since it counts the cost of 
+        // threading as work and no serial run was timed
+        double wall = seconds() - start;
+        double work = ss.s.busy + ss.s.merge;
+        fprintf(stderr, "pancake: %d threads: %.3fs elapsed, %.3fs CPU, "
+                "CPU/wall utilization %.2f\n", rule.threads, wall, work, 
+                (wall > 0) ? work / wall : 0);
+    }
+    if (stats != NULL) {
+        tableS(stats, ss.s.dict);
+        reportS(stats, stderr, !strcmp(rule.stats, "json"));
+        destroyS(stats);
+    }
+    closeSession(&ss);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Function: batchMode()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Answers the INITIAL GOAL pairs on standard input, one per line, with 
+ * bidirectional BFS.  Every answer (a path, or nothing) is followed by 
+ * an empty line, and invalid pairs are reported on standard error.  
+ * Consecutive pairs with the same GOAL share a Session, so the levels 
+ * grown from GOAL for one query are already there for the next.
+ *
+ * inputs
+ * ~~~~~~
+ * rule: pointer to Rule (without INITIAL and GOAL)
+ * stats: Stats to add to (or NULL)
+ *
+ * returns: exit status
+ **/
+int batchMode(Rule* rule, Stats* stats) {
+    int n = rule->height * rule->width;
+    char line[LINESIZE];
+    Session ss;
+    int open = false;
+    while (fgets(line, LINESIZE, stdin) != NULL) {
+        char* initial = strtok(line, " \t\r\n");
+        char* goal = strtok(NULL, " \t\r\n");
+        // Blank lines are skipped
+        if (initial == NULL) {
+            continue;
+        }
+        char* error = (goal == NULL || strtok(NULL, " \t\r\n") != NULL) 
+                ? "pancake: expected INITIAL GOAL" 
+                : checkPair(n, initial, goal);
+        if (error != NULL) {
+            fprintf(stderr, "%s\n", error);
+        } else {
+            if (open && strcmp(ss.goal, goal)) {
+                if (stats != NULL) {
+                    tableS(stats, ss.s.dict);
+                }
+                closeSession(&ss);
+                open = false;
+            }
+            if (!open && !openSession(&ss, rule, goal, stats)) {
+                die("pancake: out of memory");
+            }
+            open = true;
+            if (query(&ss, initial, true) < 0) {
+                die("pancake: out of memory");
+            }
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+    if (open) {
+        if (stats != NULL) {
+            tableS(stats, ss.s.dict);
+        }
+        closeSession(&ss);
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Function: openSession()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Sets up a Session for GOAL.  For BFS, the node of GOAL is put in the 
+ * table as the only level of the end grown from GOAL.
+ *
+ * inputs
+ * ~~~~~~
+ * ss: pointer to Session
+ * rule: pointer to Rule with the search parameters
+ * goal: GOAL
+ * stats: Stats for the searches to add to (or NULL)
+ *
+ * returns: status
+ **/
+int openSession(Session* ss, Rule* rule, char* goal, Stats* stats) {
+    int n = rule->height * rule->width;
+    ss->goal = malloc(n + 1);
+    if (ss->goal == NULL) {
+        return false;
+    }
+    strcpy(ss->goal, goal);
+    // Configurations are handled as packed keys of pk.width Words
+    createP(&ss->pk, goal, n);
+    // Every node of GOAL's end is released in one go with the Session
+    if (!createN(&ss->nodes, ss->pk.width, 1)) {
+        return false;
+    }
+    // Neighbors are hashed incrementally from the configuration they 
+    // are flipped from
+    if (!createZ(&ss->z, &ss->pk)) {
+        return false;
+    }
+    Search* s = &ss->s;
+    s->width = rule->width;
+    s->height = rule->height;
+    s->maxlen = rule->maxlen;
     // Number of possible permutations possible, within one flip
     // of a configuration
-    int nStep = 2 * (rule.width - 1) * (rule.height - 1) + (rule.width - 1) 
-                + (rule.height - 1);
-    
-    // Queue to perform BFS
-    Queue q;
-    // Queue to hold a pointer to every block of memory malloc'd 
-    // to store newly created character strings.
-    Queue p;
-    createQ(&q);
-    createQ(&p);
-    Hashtable h;
-    createH(&h, CHAINS);
+    s->nStep = countMoves(rule->width, rule->height);
+    s->threads = rule->threads;
+    s->pk = &ss->pk;
+    s->z = &ss->z;
+    s->nodes[0] = NULL;
+    s->nodes[1] = &ss->nodes;
+    s->busy = s->merge = 0;
+    s->stats = stats;
+    ss->maxmem = rule->maxmem;
+    createK(&ss->ck, rule->checkpoint, rule->every);
+    ss->resume = rule->resume;
+    // Only BFS looks configurations up by their images
+    unsigned char cells[n];
+    for (int i = 0; i < n; i++) {
+        cells[i] = ss->pk.index[(unsigned char) goal[i]];
+    }
+    s->mirror = (rule->mode == BFS && createM(&ss->mirror, &ss->pk, cells, 
+            rule->width, rule->height)) ? &ss->mirror : NULL;
+    if (!createH(&s->dict, TABLESIZE, ss->pk.width, &ss->z)) {
+        return false;
+    }
+    if (!newRoot(ss, &ss->nodes, goal)) {
+        return false;
+    }
+    ss->tree.level.lo = 0;
+    ss->tree.level.hi = 1;
+    ss->tree.depth = 0;
+    if (rule->mode == BFS) {
+        return addH(s->dict, configN(&ss->nodes, 0), refN(1, 0)) > 0;
+    }
+    return true;
+}
 
-    // Create Triples that contain information about a configuration 
-    // and a pointer to its predecessor.  Defined in LinkedList.c
-    Triple goal;
-    Triple initial;
-    initTriples(&goal, &initial, rule);
-    
-    addQ(&q, goal.config);
-    addQ(&q, initial.config);
-    addH(h, goal.config, &goal);
-    addH(h, initial.config, &initial);
+/**
+ * Function: closeSession()
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ * Frees all memory associated with a Session.
+ *
+ * input
+ * ~~~~~
+ * ss: pointer to Session
+ *
+ * returns: nothing
+ **/
+void closeSession(Session* ss) {
+    // The table only points into the nodes
+    destroyH(ss->s.dict);
+    destroyN(&ss->nodes);
+    destroyZ(&ss->z);
+    free(ss->goal);
+}
 
-    int found = 0;
-    // Pointers to keep track of configurations as we encounter them
-    char* curConfig;
-    char* nextConfig;
-    char* prevConfig;
-    Triple* curTriple;
-    Triple* nextTriple;
-    Triple* dictTriple;
-    char** batch;
+/**
+ * Function: newRoot()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Creates the node at one end of a search, which is node 0 of its 
+ * (empty) Nodes.
+ *
+ * inputs
+ * ~~~~~~
+ * ss: pointer to Session
+ * nd: pointer to Nodes of that end
+ * config: string of the configuration
+ *
+ * returns: status
+ **/
+int newRoot(Session* ss, Nodes* nd, char* config) {
+    Word key[ss->pk.width];
+    encodeP(&ss->pk, config, key);
+    return addN(nd, key, NOMOVE) == 0;
+}
 
-    // Continue BFS until we have explored every node, or found a path 
-    // between INITIAL and GOAL
-    while (!isEmptyQ(&q) && !found) {
-        removeQ(&q, &curConfig);
-        curTriple = retrieveH(h, curConfig);
-        if (curTriple == NULL) {
-            die("failed");
+/**
+ * Function: query()
+ * ~~~~~~~~~~~~~~~~~
+ * Finds and prints a shortest path from INITIAL to the GOAL of a 
+ * Session by bidirectional BFS.  The end grown from INITIAL has Nodes 
+ * of its own; when the Session will be used again, they are also taken 
+ * back out of the table afterwards, leaving only those of GOAL's end, 
+ * which keeps whatever levels this query added to it.  
+ * Otherwise a search that outgrows rankedLimit() is finished by rank.
+ * A search whose table would outgrow the Session's memory budget is 
+ * finished by perimeterSearch() instead, unless it can still be 
+ * finished by rank within the budget.  A query that is not reused 
+ * writes checkpoints if the Session has a file for them, and starts 
+ * from the Session's resume file if it has one.
+ *
+ * inputs
+ * ~~~~~~
+ * ss: pointer to Session
+ * initial: INITIAL (a permutation of GOAL)
+ * reuse: true if the Session will be used again
+ *
+ * returns: 1 if a path was found, 0 if not, -1 if memory ran out
+ **/
+int query(Session* ss, char* initial, int reuse) {
+    Search* s = &ss->s;
+    Nodes nodes;
+    if (!createN(&nodes, ss->pk.width, 0) 
+            || !newRoot(ss, &nodes, initial)) {
+        return -1;
+    }
+    s->nodes[0] = &nodes;
+    Word* root = configN(&nodes, 0);
+    int found = 0;
+    long t = retrieveH(s->dict, root);
+    if (t == MISSING && s->mirror != NULL) {
+        Word image[ss->pk.width];
+        mirrorM(s->mirror, root, image);
+        t = retrieveHashH(s->dict, image, keyZ(&ss->z, image));
+    }
+    // INITIAL has already been reached from GOAL (or is GOAL)
+    if (t != MISSING) {
+        printTrail(s, indexN(t), root);
+        found = 1;
+    } else {
+        Tree tree;
+        tree.level.lo = 0;
+        tree.level.hi = 1;
+        tree.depth = 0;
+        if (addH(s->dict, root, refN(0, 0)) == NOROOM) {
+            s->nodes[0] = NULL;
+            destroyN(&nodes);
+            return -1;
+        }
+        Tree* side[2] = {&tree, &ss->tree};
+        Checkpoint* ck = reuse ? NULL : &ss->ck;
+        if (ck != NULL) {
+            ck->initial = initial;
+            ck->goal = ss->goal;
         }
-        // Get every possible configuration within one flip of the current 
-        // configuration and enqueue them
-        if (curTriple->len < rule.maxlen) {
-            batch = getBatch(curTriple->config, rule.width, rule.height);
-            // Store pointer to free at end of program
-            for (int i = 0; i < nStep; i++) {
-                addQ(&p, batch[i]);
+        if (ck != NULL && ss->resume != NULL) {
+            Frontier level[2];
+            int depth[2];
+            int loaded = loadK(ck, ss->resume, s, level, depth);
+            if (loaded == 0) {
+                die("pancake: Invalid checkpoint for this search");
+            } else if (loaded < 0) {
+                s->nodes[0] = NULL;
+                destroyN(&nodes);
+                return -1;
             }
-            for (int i = 0; i < nStep; i++) {
-                nextConfig = batch[i];
-                // If this is our first time seeing this configuration, 
-                // add it to the queue to continue BFS
-                if ((dictTriple = retrieveH(h, batch[i])) == NULL) {
-                    nextTriple = malloc(sizeof(Triple));
-                    nextTriple->config = batch[i];
-                    nextTriple->prev = curTriple->config;
-                    nextTriple->len = curTriple->len + 1;
-                    // Inherit starting node from predecessor
-                    nextTriple->fromGoal = curTriple->fromGoal;
-                    addQ(&q, nextTriple->config);
-                    addH(h, nextTriple->config, nextTriple);
-                // If we _have_ seen this configuration before, that 
-                // means that we came from the other side of 
-                // bidirection BFS, so there is a path between 
-                // INITIAL and GOAL!
-                } else if (dictTriple->fromGoal != curTriple->fromGoal
-                        && dictTriple->len + curTriple->len < rule.maxlen) {
-                    found = 1;
-                    break;
-                }
+            for (int a = 0; a < 2; a++) {
+                side[a]->level = level[a];
+                side[a]->depth = depth[a];
             }
-            // Free pointer to array of character pointers and start over
-            free(batch);
+        }
+        // Nodes on either side of the meeting point of the two searches
+        long from;
+        long to;
+        long limit = reuse ? 0 : rankedLimit(ss);
+        long budget = 0;
+        if (ss->maxmem > 0) {
+            // A Ranked has to fit in the budget next to the table
+            long spare = ss->maxmem - ((limit > 0) ? bytesR(ss->pk.n) : 0);
+            if (spare <= 0) {
+                limit = 0;
+                spare = ss->maxmem;
+            }
+            budget = memoryLimit(ss, spare);
+        }
+        found = levelSearch(s, side, &from, &to, limit, budget, ck);
+        // Outputting if a solution was found
+        if (found == 1) {
+            printPath(s, from, to);
+        } else if (found == 2) {
+            found = (limit > 0) ? rankedFinish(ss, side) 
+                    : perimeterFinish(ss, side);
         }
     }
-    // Outputting if a solution was found
-    if (found == 1) {
-        // Array of character pointers to store the path to 
-        // INITIAL (need to be printed in reverse order)
-        char** path;
-        int pathlen;
-        // If the Triple we currently have a pointer to came from 
-        // the GOAL, then we can follow the pointers and print 
-        // the configuration out in order.  
-        if (curTriple->fromGoal == 1) {
-            path = malloc(sizeof(char*) * (dictTriple->len + 1));
-            pathlen = dictTriple->len + 1;
-            *path = dictTriple->config;
-            // Store path to INITIAL
-            while ((prevConfig = dictTriple->prev) != NULL) {
-                path++;
-                dictTriple = retrieveH(h, prevConfig);
-                *path = dictTriple->config;
+    // Unless INITIAL was found right away, all of its nodes are in dict
+    for (long i = 0; reuse && t == MISSING && i < nodes.count; i++) {
+        removeH(s->dict, configN(&nodes, i));
+    }
+    s->nodes[0] = NULL;
+    destroyN(&nodes);
+    return found;
+}
+
+/**
+ * Function: levelSearch()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Bidirectional breadth-first search between two Trees.  Every step 
+ * expands one whole level of whichever Tree's frontier is currently 
+ * smaller, using s->threads threads.
+ *
+ * The first time a neighbor turns out to have been reached from the 
+ * other side, the path through it is a shortest one: with dI and dG 
+ * complete levels on each side and no earlier meeting, no path has 
+ * fewer than dI + dG + 1 flips, and the new path has at most that many.
+ * Levels are only expanded while dI + dG < s->maxlen.
+ *
+ * A level that meets the other side is not added to the table, so 
+ * each Tree is left as a complete BFS of its first depth levels.  That 
+ * is also the case when the search stops because the table has grown 
+ * past limit, or would grow past budget with the next level (projected 
+ * from how much the last one grew), so that it can be carried on by 
+ * other means.
+ *
+ * Checkpoints are written between levels, whenever ck says one is due; 
+ * a checkpoint that cannot be written is reported and the search goes 
+ * on.
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search
+ * side: Trees grown from INITIAL and GOAL (roots already in s->dict)
+ * from: where to store the refN() of the node whose expansion met the 
+ *       other side
+ * to: where to store the refN() of the node it met
+ * limit: number of entries in s->dict to stop at (0 for no limit)
+ * budget: number of entries s->dict may not grow past (0 for no limit)
+ * ck: pointer to Checkpoint (or NULL for none)
+ *
+ * returns: 1 if a path was found, 0 if not, 2 if the table reached 
+ *          limit or budget first, -1 if memory ran out
+ **/
+int levelSearch(Search* s, Tree* side[2], long* from, long* to, 
+        long limit, long budget, Checkpoint* ck) {
+    int found = 0;
+    while (!found && side[0]->depth + side[1]->depth < s->maxlen) {
+        long count[2];
+        for (int a = 0; a < 2; a++) {
+            count[a] = side[a]->level.hi - side[a]->level.lo;
+        }
+        int a = (count[1] < count[0]) ? 1 : 0;
+        // A side with nothing left to expand has seen every 
+        // configuration it can reach, none of which met the other side
+        if (count[a] == 0) {
+            break;
+        }
+        if (limit > 0 && s->dict.table->count >= limit) {
+            found = 2;
+            break;
+        }
+        if (budget > 0 && s->dict.table->count 
+                + guessLevel(s, a, &side[a]->level) > budget) {
+            found = 2;
+            break;
+        }
+        if (dueK(ck)) {
+            Frontier level[2] = {side[0]->level, side[1]->level};
+            int depth[2] = {side[0]->depth, side[1]->depth};
+            if (!saveK(ck, s, level, depth)) {
+                fprintf(stderr, "pancake: cannot write checkpoint %s\n", 
+                        ck->file);
             }
-        } else {
-            // Store path to INITIAL
-            path = malloc(sizeof(char*) * (curTriple->len + 1));
-            pathlen = curTriple->len + 1;
-            *path = curTriple->config;
-            while ((prevConfig = curTriple->prev) != NULL) {
-                path++;
-                curTriple = retrieveH(h, prevConfig);
-                *path = curTriple->config;
+        }
+        if (s->stats != NULL && !levelS(s->stats, a, side[a]->depth, 
+                count[a])) {
+            found = -1;
+            break;
+        }
+        found = expandLevel(s, a, &side[a]->level, from, to);
+        if (found == 0) {
+            side[a]->depth++;
+        }
+    }
+    return found;
+}
+
+/**
+ * Function: rankedLimit()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Number of configurations at which the table of a query takes about 
+ * as much memory as a Ranked.  Every configuration costs a node (its 
+ * key and move) and, with the table between 3/8 and 3/4 full, up to two 
+ * Slots; a Ranked costs 4 bits for each of the n! permutations.
+ *
+ * input
+ * ~~~~~
+ * ss: pointer to Session
+ *
+ * returns: the limit, 0 if the configurations cannot be searched by rank
+ **/
+long rankedLimit(Session* ss) {
+    Packing* pk = &ss->pk;
+    if (pk->n > MAXRANKEDN || pk->nSymbols != pk->n) {
+        return 0;
+    }
+    Word state = sizeof(Word) * pk->width + sizeof(unsigned short) 
+            + 2 * sizeof(Slot);
+    return bytesR(pk->n) / state;
+}
+
+/**
+ * Function: memoryLimit()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Number of configurations the table of a query can hold in a given 
+ * number of bytes.  Every configuration costs a node and, with the 
+ * table between 3/8 and 3/4 full, up to two Slots, which are briefly 
+ * twice as many while the table doubles.  With more than one thread, 
+ * the Hashset that new configurations are claimed in while a level is 
+ * expanded (see Level.c) takes its largest size first.
+ *
+ * inputs
+ * ~~~~~~
+ * ss: pointer to Session
+ * bytes: memory available
+ *
+ * returns: the limit (at least 1)
+ **/
+long memoryLimit(Session* ss, long bytes) {
+    if (ss->s.threads > 1) {
+        bytes -= bytesT(MAXCLAIMS, ss->pk.width);
+    }
+    long state = sizeof(Word) * ss->pk.width + sizeof(unsigned short) 
+            + 4 * sizeof(Slot);
+    return (bytes / state > 0) ? bytes / state : 1;
+}
+
+/**
+ * Function: rankedFinish()
+ * ~~~~~~~~~~~~~~~~~~~~~~~~
+ * Carries on a bidirectional BFS stopped by levelSearch() with a 
+ * Ranked, and prints the path it finds.  Every node in the table is 
+ * recorded at its depth, and those on the last level of their Tree 
+ * become the frontiers.
+ *
+ * inputs
+ * ~~~~~~
+ * ss: pointer to Session (of distinct symbols)
+ * side: Trees grown from INITIAL and GOAL
+ *
+ * returns: 1 if a path was found, 0 if not, -1 if memory ran out
+ **/
+int rankedFinish(Session* ss, Tree* side[2]) {
+    Search* s = &ss->s;
+    Packing* pk = &ss->pk;
+    Ranked r;
+    if (!createR(&r, s->width, s->height)) {
+        return -1;
+    }
+    unsigned char cells[pk->n];
+    long cursor = 0;
+    long ref;
+    Word image[pk->width];
+    while ((ref = nextH(s->dict, &cursor)) != MISSING) {
+        int a = sideN(ref);
+        Word* config = configN(s->nodes[a], indexN(ref));
+        int len = depthN(s->nodes[a], indexN(ref));
+        unpackP(pk, config, cells);
+        int ok = addR(&r, a, cells, len, len == side[a]->depth);
+        // A node of GOAL's end also stands for its image
+        if (a == 1 && s->mirror != NULL) {
+            mirrorM(s->mirror, config, image);
+            if (!sameP(image, config, pk->width)) {
+                unpackP(pk, image, cells);
+                ok = ok && addR(&r, a, cells, len, len == side[a]->depth);
             }
-            // Update pointer to point to path to 
-            // GOAL
-            curTriple = dictTriple;
         }
-        // Output path to INITIAL in reverse order
-        for (int i = 0; i < pathlen; i++) {
-            printf("%s\n", *path);
-            path--;
-        } 
-        free(++path);
-        // Output path to GOAL
-        while (curTriple->prev != NULL) {
-            printf("%s\n", curTriple->config);
-            curTriple = retrieveH(h, curTriple->prev);
+        if (!ok) {
+            destroyR(&r);
+            return -1;
         }
-        printf("%s\n", curTriple->config);
     }
+    r.depth[0] = side[0]->depth;
+    r.depth[1] = side[1]->depth;
+    unsigned char* path;
+    int flips = searchR(&r, s->maxlen, &path);
+    for (int a = 0; s->stats != NULL && a < 2; a++) {
+        s->stats->expanded[a] += r.expanded[a];
+        s->stats->generated[a] += r.generated[a];
+        s->stats->duplicates[a] += r.duplicates[a];
+    }
+    destroyR(&r);
+    for (int i = 0; i <= flips; i++) {
+        printCells(pk, path + i * pk->n);
+    }
+    free(path);
+    return (flips == -2) ? -1 : (flips >= 0);
+}
 
+/**
+ * Function: perimeterFinish()
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Carries on a bidirectional BFS stopped by levelSearch() with a 
+ * perimeterSearch() from the frontier of INITIAL's end, without adding 
+ * to the table, and prints the path it finds.
+ *
+ * inputs
+ * ~~~~~~
+ * ss: pointer to Session
+ * side: Trees grown from INITIAL and GOAL
+ *
+ * returns: 1 if a path was found, 0 if not, -1 if memory ran out
+ **/
+int perimeterFinish(Session* ss, Tree* side[2]) {
+    Search* s = &ss->s;
+    Packing* pk = &ss->pk;
+    long from;
+    long to;
+    unsigned char* path;
+    int flips = perimeterSearch(s, &side[0]->level, side[0]->depth, 
+            side[1]->depth, &from, &path, &to);
+    if (flips < 0) {
+        return (flips == -2) ? -1 : 0;
+    }
+    printChain(s, s->nodes[0], from);
+    for (int i = 0; i < flips - 1; i++) {
+        printCells(pk, path + i * pk->n);
+    }
+    // The last configuration is the one node to stands for
+    Word actual[pk->width];
+    packP(pk, path + (flips - 1) * pk->n, actual);
+    printTrail(s, to, actual);
+    free(path);
+    return 1;
+}
+
+/**
+ * Function: informedSearch()
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Finds and prints a shortest path from INITIAL to GOAL with A* or 
+ * IDA* (rule->mode), guided by the breakpoint bound and, if one was 
+ * given, a pattern database.
+ *
+ * inputs
+ * ~~~~~~
+ * ss: pointer to Session (GOAL not in the table)
+ * rule: pointer to Rule
+ *
+ * returns: 1 if a path was found, 0 if not, -1 if memory ran out
+ **/
+int informedSearch(Session* ss, Rule* rule) {
+    Search* s = &ss->s;
+    Packing* pk = &ss->pk;
+    Word* goal = configN(&ss->nodes, 0);
+    Nodes nodes;
+    if (!createN(&nodes, pk->width, 0) 
+            || !newRoot(ss, &nodes, rule->initial)) {
+        return -1;
+    }
+    s->nodes[0] = &nodes;
+    Word* initial = configN(&nodes, 0);
+    if (addH(s->dict, initial, refN(0, 0)) == NOROOM) {
+        destroyN(&nodes);
+        return -1;
+    }
+    // INITIAL == GOAL is a path of no flips
+    if (sameP(initial, goal, pk->width)) {
+        printConfig(pk, initial);
+        destroyN(&nodes);
+        return 1;
+    }
+    // Informed searches need GOAL unpacked to build their bound
+    unsigned char initCells[pk->n];
+    unsigned char goalCells[pk->n];
+    unpackP(pk, initial, initCells);
+    unpackP(pk, goal, goalCells);
+    Bound b;
+    if (!createB(&b, goalCells, rule->width, rule->height, pk->nSymbols)) {
+        destroyN(&nodes);
+        return -1;
+    }
+    Database db;
+    if (rule->pdb != NULL) {
+        if (!loadD(&db, pk, rule->goal, rule->width, rule->height, 
+                rule->pdb)) {
+            die("pancake: Invalid pattern database for GOAL");
+        }
+        b.db = &db;
+    }
+    int found = 0;
+    if (rule->mode == ASTAR) {
+        long last;
+        found = astarSearch(s, &b, goal, &last);
+        if (found == 1) {
+            printChain(s, &nodes, last);
+        }
+    } else {
+        unsigned char* path;
+        int flips = idastarSearch(s, &b, initCells, goalCells, &path);
+        for (int i = 0; i <= flips; i++) {
+            printCells(pk, path + i * pk->n);
+        }
+        free(path);
+        found = (flips >= 0);
+    }
+    if (b.db != NULL) {
+        destroyD(b.db);
+    }
+    destroyB(&b);
+    s->nodes[0] = NULL;
+    destroyN(&nodes);
+    return found;
+}
 
-    // Free all blocks of character strings we allocated by 
-    // flipPancake()
-    while (!isEmptyQ(&p)) {
-        removeQ(&p, &nextConfig);
-        free(nextConfig);
-    }
-    // Remove configurations from dict that _weren't_ malloc'd
-    removeH(h, goal.config);
-    removeH(h, initial.config);
-    // destroy dict, which frees payloads as well
-    destroyH(h);
-    destroyQ(&p);
-    destroyQ(&q);
+/**
+ * Function: tableSearch()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Answers a query from the distance table in rule->table, building the 
+ * table (and trying to save it there) first if the file does not hold 
+ * one for this board.  INITIAL is relabeled so that GOAL becomes the 
+ * identity; a shortest path is then traced by always taking a flip to 
+ * a configuration one step closer, and relabeled back for printing.
+ *
+ * input
+ * ~~~~~
+ * rule: pointer to Rule
+ *
+ * returns: exit status
+ **/
+int tableSearch(Rule* rule) {
+    int n = rule->height * rule->width;
+    Packing pk;
+    createP(&pk, rule->goal, n);
+    if (n > MAXCAYLEYN) {
+        fprintf(stderr, "pancake: -table needs at most %d cells\n", 
+                MAXCAYLEYN);
+        exit(EXIT_FAILURE);
+    } else if (pk.nSymbols != n) {
+        die("pancake: -table needs every symbol in GOAL to be distinct");
+    }
+    Cayley c;
+    if (!loadC(&c, rule->width, rule->height, rule->table)) {
+        if (!buildC(&c, rule->width, rule->height)) {
+            die("pancake: cannot build distance table");
+        }
+        // Still usable from memory if it cannot be saved
+        if (!saveC(&c, rule->table)) {
+            fprintf(stderr, "pancake: cannot write %s\n", rule->table);
+        }
+    }
+    unsigned char cells[n];
+    unsigned char goal[n];
+    unsigned char perm[n];
+    unsigned char next[n];
+    for (int i = 0; i < n; i++) {
+        cells[i] = pk.index[(unsigned char) rule->initial[i]];
+        goal[i] = pk.index[(unsigned char) rule->goal[i]];
+    }
+    relabelC(cells, goal, n, perm);
+    int d = distanceC(&c, perm);
+    if (d <= rule->maxlen) {
+        int nStep = countMoves(rule->width, rule->height);
+        Move moves[nStep + 1];
+        listMoves(rule->width, rule->height, moves);
+        for (; d >= 0; d--) {
+            for (int i = 0; i < n; i++) {
+                cells[i] = goal[perm[i]];
+            }
+            printCells(&pk, cells);
+            for (int i = 0; i < nStep && d > 0; i++) {
+                Move m = moves[i];
+                flipPancake(perm, next, rule->width, rule->height, 
+                        m.fw, m.fh, m.v);
+                if (distanceC(&c, next) == d - 1) {
+                    memcpy(perm, next, n);
+                    break;
+                }
+            }
+        }
+    }
+    destroyC(&c);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Function: diskQuery()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Finds and prints a shortest path from INITIAL to GOAL with 
+ * diskSearch(), which keeps its levels in files in rule->dir and uses 
+ * one thread.
+ *
+ * input
+ * ~~~~~
+ * rule: pointer to Rule
+ *
+ * returns: exit status
+ **/
+int diskQuery(Rule* rule) {
+    Packing pk;
+    createP(&pk, rule->goal, rule->height * rule->width);
+    Word initial[pk.width];
+    Word goal[pk.width];
+    encodeP(&pk, rule->initial, initial);
+    encodeP(&pk, rule->goal, goal);
+    Word* path;
+    int flips = diskSearch(&pk, rule->width, rule->height, rule->maxlen, 
+            rule->dir, initial, goal, &path);
+    if (flips == NOWRITE) {
+        fprintf(stderr, "pancake: cannot write to %s\n", rule->dir);
+        exit(EXIT_FAILURE);
+    } else if (flips == NOSPACE) {
+        die("pancake: out of memory or disk space");
+    }
+    for (int i = 0; i <= flips; i++) {
+        printConfig(&pk, path + i * pk.width);
+    }
+    free(path);
     return EXIT_SUCCESS;
 }
 
+/**
+ * Function: printPath()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Prints the path from INITIAL to GOAL through two adjacent nodes that 
+ * were reached from opposite ends of the search.
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search
+ * from: refN() of the node whose expansion met the other side
+ * to: refN() of the node it met
+ *
+ * returns: nothing
+ **/
+void printPath(Search* s, long from, long to) {
+    // Make from the one reached from INITIAL
+    if (sideN(from) == 1) {
+        long swap = from;
+        from = to;
+        to = swap;
+    }
+    Word* initial = configN(s->nodes[0], indexN(from));
+    printChain(s, s->nodes[0], indexN(from));
+    Word actual[s->pk->width];
+    alignImage(s, initial, configN(s->nodes[1], indexN(to)), actual);
+    printTrail(s, indexN(to), actual);
+}
+
+/**
+ * Function: printTrail()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * Prints the configurations from a node of GOAL's end back to GOAL by 
+ * following parents, which for GOAL's end is already in order.  With a 
+ * Mirror, each node on the way may hold the image of the configuration 
+ * on the path, which is then the one a flip away.
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search
+ * first: node of s->nodes[1] to start from
+ * actual: configuration on the path that first stands for
+ *
+ * returns: nothing
+ **/
+void printTrail(Search* s, long first, Word* actual) {
+    Nodes* nd = s->nodes[1];
+    int width = s->pk->width;
+    Word cur[width];
+    memcpy(cur, actual, sizeof(cur));
+    while ((first = findParent(s, nd, first)) != NOPARENT) {
+        printConfig(s->pk, cur);
+        alignImage(s, cur, configN(nd, first), cur);
+    }
+    printConfig(s->pk, cur);
+}
+
+/**
+ * Function: alignImage()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * Picks whichever of a configuration and its image is one flip from 
+ * another configuration (the configuration itself without a Mirror).
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search
+ * from: configuration on the path
+ * config: configuration kept for the next one
+ * out: where to store the next one (may be from)
+ *
+ * returns: nothing
+ **/
+void alignImage(Search* s, Word* from, Word* config, Word* out) {
+    int width = s->pk->width;
+    Word image[width];
+    if (s->mirror == NULL) {
+        memcpy(out, config, sizeof(image));
+        return;
+    }
+    Word batch[(s->nStep + 1) * width];
+    getBatch(s->pk, from, s->width, s->height, batch, NULL, 0, NULL);
+    for (int i = 0; i < s->nStep; i++) {
+        if (sameP(batch + i * width, config, width)) {
+            memcpy(out, config, sizeof(image));
+            return;
+        }
+    }
+    mirrorM(s->mirror, config, image);
+    memcpy(out, image, sizeof(image));
+}
+
+/**
+ * Function: printChain()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * Prints the configurations from the root of a search up to and 
+ * including last, by following parents back to the root.
+ *
+ * inputs
+ * ~~~~~~
+ * s: pointer to Search
+ * nd: pointer to Nodes of the search
+ * last: node at the end of the chain
+ *
+ * returns: nothing
+ **/
+void printChain(Search* s, Nodes* nd, long last) {
+    int pathlen = 0;
+    for (long i = last; i != NOPARENT; i = findParent(s, nd, i)) {
+        pathlen++;
+    }
+    // Nodes on the path back to the root (need to be printed in 
+    // reverse order)
+    long* path = malloc(sizeof(long) * pathlen);
+    pathlen = 0;
+    for (long i = last; i != NOPARENT; i = findParent(s, nd, i)) {
+        path[pathlen++] = i;
+    }
+    while (pathlen > 0) {
+        long i = path[--pathlen];
+        printConfig(s->pk, configN(nd, i));
+    }
+    free(path);
+}
+
 /**
  * Function: parseArgs()
  * ~~~~~~~~~~~~~~~~~~~~~
@@ -217,14 +1100,102 @@ int main(int argc, char* argv[]) {
  * returns: 0 upon success (no invalid input)
  **/
 int parseArgs(Rule* rule, int argc, char* argv[]) {
-    // Check for correct number of arguments
-    if (argc != 4 && argc != 6) {
-        die("pancake: pancake [HEIGHT WIDTH] MAXLENGTH INITIAL GOAL");
-    }
     int curArg = 1;
     char* endptr;
+    rule->threads = 1;
+    rule->mode = BFS;
+    rule->batch = false;
+    rule->pdb = NULL;
+    rule->table = NULL;
+    rule->dir = NULL;
+    rule->stats = NULL;
+    rule->maxmem = 0;
+    rule->checkpoint = NULL;
+    rule->resume = NULL;
+    rule->every = CKEVERY;
+    // Parse options, which all come before the positional arguments
+    while (curArg < argc && argv[curArg][0] == '-') {
+        if (!strcmp(argv[curArg], "-j") && curArg + 1 < argc) {
+            if ((rule->threads = strtol(argv[curArg + 1], &endptr, BASE)) 
+                    < 1 || rule->threads > MAXTHREADS || *endptr != '\0') {
+                die("pancake: Invalid -j");
+            }
+            curArg += 2;
+        } else if (!strcmp(argv[curArg], "-astar")) {
+            rule->mode = ASTAR;
+            curArg++;
+        } else if (!strcmp(argv[curArg], "-idastar")) {
+            rule->mode = IDASTAR;
+            curArg++;
+        } else if (!strcmp(argv[curArg], "-pdb") && curArg + 1 < argc) {
+            rule->pdb = argv[curArg + 1];
+            curArg += 2;
+        } else if (!strcmp(argv[curArg], "-table") && curArg + 1 < argc) {
+            rule->mode = TABLE;
+            rule->table = argv[curArg + 1];
+            curArg += 2;
+        } else if (!strcmp(argv[curArg], "-disk") && curArg + 1 < argc) {
+            rule->mode = DISK;
+            rule->dir = argv[curArg + 1];
+            curArg += 2;
+        } else if (!strcmp(argv[curArg], "-stats") && curArg + 1 < argc) {
+            rule->stats = argv[curArg + 1];
+            if (strcmp(rule->stats, "text") && strcmp(rule->stats, "json")) {
+                die("pancake: Invalid -stats (text or json)");
+            }
+            curArg += 2;
+        } else if (!strcmp(argv[curArg], "-maxmem") && curArg + 1 < argc) {
+            if ((rule->maxmem = parseSize(argv[curArg + 1])) <= 0) {
+                die("pancake: Invalid -maxmem");
+            }
+            curArg += 2;
+        } else if (!strcmp(argv[curArg], "-checkpoint") 
+                && curArg + 1 < argc) {
+            rule->checkpoint = argv[curArg + 1];
+            curArg += 2;
+        } else if (!strcmp(argv[curArg], "-every") && curArg + 1 < argc) {
+            if ((rule->every = strtol(argv[curArg + 1], &endptr, BASE)) < 0
+                    || *endptr != '\0') {
+                die("pancake: Invalid -every");
+            }
+            curArg += 2;
+        } else if (!strcmp(argv[curArg], "-resume") && curArg + 1 < argc) {
+            rule->resume = argv[curArg + 1];
+            curArg += 2;
+        } else if (!strcmp(argv[curArg], "-batch")) {
+            rule->batch = true;
+            curArg++;
+        } else {
+            die(USAGE);
+        }
+    }
+    // A pattern database is only of use to an informed search
+    if (rule->pdb != NULL && rule->mode == BFS) {
+        rule->mode = ASTAR;
+    }
+    if (rule->batch && rule->mode != BFS) {
+        die("pancake: -batch only works with BFS");
+    }
+    if (rule->stats != NULL && rule->mode != BFS) {
+        die("pancake: -stats only works with BFS");
+    }
+    if (rule->maxmem > 0 && rule->mode != BFS) {
+        die("pancake: -maxmem only works with BFS");
+    }
+    // Checkpoints are of a single search
+    if ((rule->checkpoint != NULL || rule->resume != NULL) 
+            && (rule->mode != BFS || rule->batch)) {
+        die("pancake: -checkpoint and -resume only work with BFS, "
+                "without -batch");
+    }
+    // Check for correct number of arguments (INITIAL and GOAL come 
+    // from standard input in batch mode)
+    int nArgs = rule->batch ? 1 : 3;
+    if (argc - curArg != nArgs && argc - curArg != nArgs + 2) {
+        die(USAGE);
+    }
     // If width and length are supplied, parse them
-    if (argc == 6) {
+    if (argc - curArg == nArgs + 2) {
         if ((rule->height = strtol(argv[curArg++], &endptr, BASE)) < MINWH || 
                 rule->height > MAXWH) {
             die("pancake: Invalid HEIGHT");
@@ -248,138 +1219,121 @@ int parseArgs(Rule* rule, int argc, char* argv[]) {
     } else if (*endptr != '\0') {
         die("pancake: Invalid MAXLENGTH"); 
     }
-    if (strlen(rule->initial = argv[curArg++]) != rule->height * rule->width) {
-        die("pancake: strlen(INITIAL) != HEIGHT*WIDTH");
+    if (rule->batch) {
+        rule->initial = rule->goal = NULL;
+        return 0;
+    }
+    rule->initial = argv[curArg++];
+    rule->goal = argv[curArg];
+    char* error = checkPair(rule->height * rule->width, rule->initial, 
+            rule->goal);
+    if (error != NULL) {
+        die(error);
     }
-    if (strlen(rule->goal = argv[curArg]) != rule->height * rule->width) {
-        die("pancake: strlen(GOAL) != HEIGHT*WIDTH");
-    } 
-    // Check whether INITIAL and GOAL are permutations
-    // If not, quit immediately.  there is no possible path between them
-    char* goalChars;
-    char* initChars;
-    goalChars = malloc(sizeof(char) * (rule->height * rule->width + 1));
-    initChars = malloc(sizeof(char) * (rule->height * rule->width + 1));
-    memset(goalChars, 0, sizeof(*goalChars));
-    memset(initChars, 0, sizeof(*initChars));
-    sort(&(rule->initial), &initChars, rule->height * rule->width);
-    sort(&(rule->goal), &goalChars, rule->height * rule->width);
-    if (strcmp(goalChars, initChars)) {
-        die("pancake: GOAL != permutation of INITIAL");
-    } 
-    free(goalChars);
-    free(initChars);
     return 0;
 }
 
 /**
- * Function: initTriples()
- * ~~~~~~~~~~~~~~~~~~~~~~~
- * Initalizes the INITIAL and GOAL Triple structs.
+ * Function: parseSize()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Parses a number of bytes, optionally followed by K, M or G for 
+ * multiples of 1024.
+ *
+ * input
+ * ~~~~~
+ * arg: argument string
+ *
+ * returns: the number of bytes, 0 if arg is not a valid size
+ **/
+long parseSize(char* arg) {
+    char* units = "KMG";
+    char* endptr;
+    long size = strtol(arg, &endptr, BASE);
+    int shift = 0;
+    if (*endptr != '\0') {
+        char* unit = strchr(units, *endptr);
+        if (unit == NULL || *unit == '\0' || endptr[1] != '\0') {
+            return 0;
+        }
+        shift = 10 * (unit - units + 1);
+    }
+    if (size <= 0 || size > (LONG_MAX >> shift)) {
+        return 0;
+    }
+    return size << shift;
+}
+
+/**
+ * Function: checkPair()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Checks that INITIAL and GOAL have the right length and are 
+ * permutations of each other.  If not, there is no possible path 
+ * between them.
  *
  * inputs
  * ~~~~~~
- * initial: pointer to triple
- * goal: pointer to triple
- * rule: Rule struct specifying INITIAL and GOAL
+ * n: number of cells
+ * initial: INITIAL
+ * goal: GOAL
  *
- * returns: 0 upon successful parsing
+ * returns: NULL if the pair is valid, an error message otherwise
  **/
-int initTriples(Triple* initial, Triple* goal, Rule rule) {
-    goal->config = rule.goal;
-    goal->prev = NULL;
-    goal->len = 0;
-    goal->fromGoal = 1;
-    initial->config = rule.initial;
-    initial->prev = NULL;
-    initial->len = 0;
-    initial->fromGoal = 0;
-    return 0;
+char* checkPair(int n, char* initial, char* goal) {
+    if (strlen(initial) != n) {
+        return "pancake: strlen(INITIAL) != HEIGHT*WIDTH";
+    }
+    if (strlen(goal) != n) {
+        return "pancake: strlen(GOAL) != HEIGHT*WIDTH";
+    } 
+    char* goalChars;
+    char* initChars;
+    goalChars = malloc(sizeof(char) * (n + 1));
+    initChars = malloc(sizeof(char) * (n + 1));
+    sort(&initial, &initChars, n);
+    sort(&goal, &goalChars, n);
+    int same = !strcmp(goalChars, initChars);
+    free(goalChars);
+    free(initChars);
+    return same ? NULL : "pancake: GOAL != permutation of INITIAL";
 }
 
 /**
- * Function: flipPancake()
- * ~~~~~~~~~~~~~~~~~~~~~~~
- * Given a character string, creates a horizontal or vertical "flip" 
- * permutation of it along a specified width and height.
+ * Function: printCells()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * Prints an unpacked configuration as a line of characters.
  *
  * input
  * ~~~~~
- * old: character string of configuration to permute
- * w: width of old
- * h: height of old
- * fw: width of the flip, starting from upper left
- * fh: height of the flip, starting from upper left
- * v: 1 if vertical flip, 0 if horizontal flip
- *
- * returns: pointer to sequence of permuted characters
+ * pk: pointer to Packing used for cells
+ * cells: symbol indices of the configuration
+ *
+ * returns: nothing
  **/
-char* flipPancake(char* old, int w, int h, int fw, int fh, int v) {
-    char* new;
-    new = malloc(sizeof(char) * (w * h + 1));
-    for (int i = 0; i < w * fh; i++) {
-        // Permuting of characters only necessary if we are 
-        // in a column that is permuted
-        if (i % w < fw) {
-            // Permute characters depending on vertical/horizontal flip
-            if (v) {
-               new[(i / w) * w + fw - 1 - (i % w)] = old[i];
-            } else {
-               new[(fh - 1 - (i / w)) * w + (i % w)] = old[i]; 
-            }
-        } else {
-            new[i] = old[i];
-        }
+void printCells(Packing* pk, unsigned char* cells) {
+    char line[pk->n + 1];
+    for (int i = 0; i < pk->n; i++) {
+        line[i] = pk->symbol[cells[i]];
     }
-    // Copy characters on rows that do not require permuting 
-    // directly
-    for (int i = w * fh; i < w * h; i++) {
-        new[i] = old[i];
-    }
-    new[w * h] = '\0';
-    return new;
+    line[pk->n] = '\0';
+    printf("%s\n", line);
 }
 
-
 /**
- * Function: getBatch()
- * ~~~~~~~~~~~~~~~~~~~~
- * Given a configuration, its width, and its height, getBatch() returns a 
- * pointer to a series af character pointers to possible permutations 
- * reachable from a single flip.  
- *
- * (w - 1) * (h - 1) + (w - 1) + (h - 1) configurations are returned.
+ * Function: printConfig()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Prints a packed configuration as a line of characters.
  *
  * input
  * ~~~~~
- * config: character string to be permuted
- * w: width of config
- * h: height of config
+ * pk: pointer to Packing used for config
+ * config: packed configuration
  *
- * returns: pointer to character pointer
+ * returns: nothing
  **/
-char** getBatch(char* config, int w, int h) {
-    // Pointer to first permutation (to be returned)
-    char** batch;
-    // Pointer to current permutation (updated on each iteration)
-    char** pancake;
-    batch = malloc(sizeof(char*) * (2 * (w - 1) * (h - 1) + (w - 1) + (h - 1)));
-    pancake = batch;
-    for (int i = 0; i < w; i++) {
-        for (int j = 0; j < h; j++) {
-            // Don't create a permutation with a flip height of 
-            // 1 and flip width of 1... it's invariant
-            if (i != 0) {
-                *pancake = flipPancake(config, w, h, i + 1, j + 1, 1);
-                pancake++;
-            }
-            if (j != 0) {
-                *pancake = flipPancake(config, w, h, i + 1, j + 1, 0);
-                pancake++;
-            }
-        }
-    }
-    return batch;
+void printConfig(Packing* pk, Word* config) {
+    char line[pk->n + 1];
+    decodeP(pk, config, line);
+    printf("%s\n", line);
 }
 
 /**
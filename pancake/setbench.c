@@ -0,0 +1,378 @@
+/**
+ * setbench.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * setbench stresses a Hashset with 1, 2, 4, 8 and 16 threads adding
+ * keys at once, and reports how many insertions per second each run
+ * made.  Three streams are run for every number of threads:
+ *
+ *  - mixed: every one of KEYS keys appears DUPS times, in a random
+ *    order split between the threads, as neighbors of a BFS level do;
+ *  - contended: every thread adds every key in the same order, so that
+ *    threads race for the same slots all the time;
+ *  - full: the keys are added to a set with room for half of them.
+ *
+ * After every run the set is checked: every key was added exactly once
+ * over all threads, every slot holds a key that was added with its own
+ * hash and payload, and no key is in two slots.  Any failure is reported
+ * and makes the exit status nonzero.
+ *
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "Hashset.h"
+
+#define die(msg)    exit (fprintf (stderr, "%s\n", msg))
+#define USAGE "setbench: setbench [-n KEYS] [-d DUPS] [-w WIDTH]"
+// Base 10 integers should be returned from strtol()
+#define BASE 10
+// Default number of distinct keys, copies of each in the mixed stream
+// and Words per key
+#define KEYS (1L << 20)
+#define DUPS 4
+#define WIDTH 1
+// Largest number of threads run, and of Words per key
+#define MAXTHREADS 16
+#define MAXWIDTH 8
+// Streams run for every number of threads
+#define MIXED 0
+#define CONTENDED 1
+#define FILLED 2
+
+/**
+ * Struct: Stream
+ * ~~~~~~~~~~~~~~
+ * Keys to add, shared by the threads of a run.
+ *
+ * members
+ * ~~~~~~~
+ * Word* key:       KEYS distinct keys, width Words each
+ * unsigned long* hash:     hash of each key
+ * long* order:     indices of the keys in the mixed stream
+ * long nKeys:      number of distinct keys
+ * long nOrder:     length of order
+ * int width:       Words per key
+ **/
+typedef struct Stream {
+    Word* key;
+    unsigned long* hash;
+    long* order;
+    long nKeys;
+    long nOrder;
+    int width;
+} Stream;
+
+/**
+ * Struct: Runner
+ * ~~~~~~~~~~~~~~
+ * One thread of a run.
+ *
+ * members
+ * ~~~~~~~
+ * Stream* st:      keys to add
+ * Hashset* set:    set they are added to
+ * pthread_barrier_t* start:    lets every thread start at once
+ * int kind:        MIXED, CONTENDED or FILLED
+ * long lo, hi:     part of the stream this thread adds
+ * long added, present, full:   results of insertT()
+ **/
+typedef struct Runner {
+    Stream* st;
+    Hashset* set;
+    pthread_barrier_t* start;
+    int kind;
+    long lo;
+    long hi;
+    long added;
+    long present;
+    long full;
+} Runner;
+
+void* runInserts(void* arg);
+double runStream(Stream* st, Hashset* set, int kind, int threads,
+        long* added, long* full);
+int checkSet(Stream* st, Hashset* set, long added);
+unsigned long nextRandom(unsigned long* state);
+unsigned long hashKey(Word* key, int width);
+double seconds(void);
+
+int main(int argc, char* argv[]) {
+    int curArg = 1;
+    char* endptr;
+    long keys = KEYS;
+    long dups = DUPS;
+    long width = WIDTH;
+    while (curArg + 1 < argc && argv[curArg][0] == '-') {
+        long value = strtol(argv[curArg + 1], &endptr, BASE);
+        if (*endptr != '\0' || value < 1) {
+            die(USAGE);
+        }
+        if (!strcmp(argv[curArg], "-n")) {
+            keys = value;
+        } else if (!strcmp(argv[curArg], "-d")) {
+            dups = value;
+        } else if (!strcmp(argv[curArg], "-w") && value <= MAXWIDTH) {
+            width = value;
+        } else {
+            die(USAGE);
+        }
+        curArg += 2;
+    }
+    if (curArg != argc) {
+        die(USAGE);
+    }
+
+    // Distinct keys, and the mixed stream as a shuffled multiset of them
+    Stream st;
+    st.nKeys = keys;
+    st.nOrder = keys * dups;
+    st.width = width;
+    st.key = malloc(sizeof(Word) * width * keys);
+    st.hash = malloc(sizeof(unsigned long) * keys);
+    st.order = malloc(sizeof(long) * st.nOrder);
+    if (st.key == NULL || st.hash == NULL || st.order == NULL) {
+        die("setbench: out of memory");
+    }
+    unsigned long state = 223;
+    for (long i = 0; i < keys; i++) {
+        for (int j = 0; j < width; j++) {
+            st.key[i * width + j] = nextRandom(&state);
+        }
+        st.hash[i] = hashKey(st.key + i * width, width);
+    }
+    for (long i = 0; i < st.nOrder; i++) {
+        st.order[i] = i % keys;
+    }
+    for (long i = st.nOrder - 1; i > 0; i--) {
+        long j = nextRandom(&state) % (i + 1);
+        long swap = st.order[i];
+        st.order[i] = st.order[j];
+        st.order[j] = swap;
+    }
+
+    printf("setbench: %ld keys x %ld, width %ld\n", keys, dups, width);
+    printf("threads   mixed Mops/s   contended Mops/s   full Mops/s\n");
+    int failed = false;
+    for (int threads = 1; threads <= MAXTHREADS; threads *= 2) {
+        double rate[3];
+        for (int kind = MIXED; kind <= FILLED; kind++) {
+            Hashset set;
+            long room = (kind == FILLED) ? keys / 2 : keys;
+            if (!createT(&set, room, width)) {
+                die("setbench: out of memory");
+            }
+            long added;
+            long full;
+            double elapsed = runStream(&st, &set, kind, threads, &added,
+                    &full);
+            long ops = (kind == MIXED) ? st.nOrder
+                    : (kind == CONTENDED) ? keys * threads : keys;
+            rate[kind] = (elapsed > 0) ? ops / elapsed / 1e6 : 0;
+            // Only a set that ran out of room may turn keys away, and
+            // then only once it is (nearly) full
+            int ok = checkSet(&st, &set, added);
+            if (kind != FILLED) {
+                ok = ok && added == keys && full == 0;
+            } else {
+                ok = ok && added <= set.limit && added + full == keys
+                        && added > set.limit - threads;
+            }
+            if (!ok) {
+                fprintf(stderr, "setbench: %d threads, stream %d: "
+                        "FAILED (%ld added, %ld full)\n", threads, kind,
+                        added, full);
+                failed = true;
+            }
+            destroyT(&set);
+        }
+        printf("%7d   %12.2f   %16.2f   %11.2f\n", threads, rate[MIXED],
+                rate[CONTENDED], rate[FILLED]);
+        fflush(stdout);
+    }
+    free(st.key);
+    free(st.hash);
+    free(st.order);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * Function: runStream()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Adds a stream of keys to a set with a number of threads, which all
+ * start together.
+ *
+ * inputs
+ * ~~~~~~
+ * st: pointer to Stream
+ * set: pointer to an empty Hashset
+ * kind: MIXED, CONTENDED or FILLED
+ * threads: number of threads
+ * added: where to store the number of keys added over all threads
+ * full: where to store the number of keys turned away
+ *
+ * returns: seconds from the start to the last thread finishing
+ **/
+double runStream(Stream* st, Hashset* set, int kind, int threads,
+        long* added, long* full) {
+    Runner rn[threads];
+    pthread_t thread[threads];
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, threads);
+    long length = (kind == MIXED) ? st->nOrder : st->nKeys;
+    for (int i = 0; i < threads; i++) {
+        rn[i].st = st;
+        rn[i].set = set;
+        rn[i].start = &start;
+        rn[i].kind = kind;
+        // Contended runs give every thread the whole stream
+        rn[i].lo = (kind == CONTENDED) ? 0 : length * i / threads;
+        rn[i].hi = (kind == CONTENDED) ? length : length * (i + 1) / threads;
+        rn[i].added = rn[i].present = rn[i].full = 0;
+    }
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&thread[i], NULL, runInserts, &rn[i])) {
+            die("setbench: cannot start a thread");
+        }
+    }
+    double t0 = seconds();
+    runInserts(&rn[0]);
+    for (int i = 1; i < threads; i++) {
+        pthread_join(thread[i], NULL);
+    }
+    double elapsed = seconds() - t0;
+    pthread_barrier_destroy(&start);
+    *added = *full = 0;
+    for (int i = 0; i < threads; i++) {
+        *added += rn[i].added;
+        *full += rn[i].full;
+    }
+    return elapsed;
+}
+
+/**
+ * Function: runInserts()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * Thread body: adds this thread's part of the stream.
+ *
+ * input
+ * ~~~~~
+ * arg: pointer to Runner
+ *
+ * returns: NULL
+ **/
+void* runInserts(void* arg) {
+    Runner* rn = arg;
+    Stream* st = rn->st;
+    pthread_barrier_wait(rn->start);
+    for (long i = rn->lo; i < rn->hi; i++) {
+        long k = (rn->kind == MIXED) ? st->order[i] : i;
+        int result = insertT(rn->set, st->key + k * st->width, st->hash[k],
+                k);
+        if (result == ADDED) {
+            rn->added++;
+        } else if (result == PRESENT) {
+            rn->present++;
+        } else {
+            rn->full++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Function: checkSet()
+ * ~~~~~~~~~~~~~~~~~~~~
+ * Checks a set once every thread is done: it holds as many keys as were
+ * added, each slot holds the key its payload names along with that
+ * key's hash, and no key is held twice.
+ *
+ * inputs
+ * ~~~~~~
+ * st: pointer to Stream the keys came from
+ * set: pointer to Hashset
+ * added: number of keys the threads were told they added
+ *
+ * returns: true if the set is sound
+ **/
+int checkSet(Stream* st, Hashset* set, long added) {
+    char* seen = calloc(st->nKeys, 1);
+    if (seen == NULL) {
+        die("setbench: out of memory");
+    }
+    int ok = (set->count == added);
+    long held = 0;
+    long cursor = 0;
+    long i;
+    while (ok && (i = nextT(set, &cursor)) >= 0) {
+        long k = valueT(set, i);
+        ok = k >= 0 && k < st->nKeys && !seen[k]
+                && hashT(set, i) == st->hash[k]
+                && sameP(keyT(set, i), st->key + k * st->width, st->width);
+        if (ok) {
+            seen[k] = true;
+        }
+        held++;
+    }
+    free(seen);
+    return ok && held == added;
+}
+
+/**
+ * Function: hashKey()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Hashes a key a Word at a time with the splitmix64 finalizer.
+ *
+ * inputs
+ * ~~~~~~
+ * key: the key
+ * width: number of Words in it
+ *
+ * returns: hash of key
+ **/
+unsigned long hashKey(Word* key, int width) {
+    unsigned long h = 0;
+    for (int i = 0; i < width; i++) {
+        unsigned long state = h ^ key[i];
+        h = nextRandom(&state);
+    }
+    return h;
+}
+
+/**
+ * Function: nextRandom()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * splitmix64 generator, as in Zobrist.c.
+ *
+ * input
+ * ~~~~~
+ * state: state of the generator
+ *
+ * returns: next number
+ **/
+unsigned long nextRandom(unsigned long* state) {
+    unsigned long x = (*state += 0x9E3779B97F4A7C15UL);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Function: seconds()
+ * ~~~~~~~~~~~~~~~~~~~
+ * Reads a monotonic clock.
+ *
+ * returns: time in seconds since an arbitrary starting point
+ **/
+double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,1049 @@
+/**
+ * tablebench.c
+ *
+ * Computer Science 223
+ * Homework 5
+ *
+ * Addison Hu
+ * addison.hu@yale.edu
+ *
+ * tablebench replays streams of table operations through several ways
+ * of resolving collisions, and reports the latency of insertions, hits
+ * and misses and the bytes each table takes per entry.  The tables are
+ *
+ *  - hashtable: Hashtable itself (linear probing, growing at 3/4 full);
+ *  - chained:   the chains of LinkedList.c that pancake's first table was
+ *    made of, with as many chains as keys in the stream;
+ *  - chained-mtf: the same, moving every key found to the front of its
+ *    chain;
+ *  - robinhood: linear probing where a key being inserted takes the slot
+ *    of any key closer to its own home slot, so that misses stop early;
+ *  - cuckoo:    two candidate buckets of CUCKOOWAYS slots per key, making
+ *    room by moving keys to their other bucket;
+ *  - swiss:     groups of GROUP slots with a byte of tag per slot,
+ *    compared a whole group at a time (with SSE2 where available).
+ *
+ * Every table keeps a pointer to the key, as Hashtable does with the
+ * keys in Nodes, and is handed the hash of the key.  Each stream is
+ *
+ *  - bfs-*: recorded from a BFS from GOAL, the way pancake's table sees
+ *    it: every neighbor is looked up, and the ones not found are added;
+ *  - uniform: random keys of two Words, all added, then looked up in a
+ *    random order mixed with as many keys that were never added.
+ *
+ * Every operation is timed on its own, less the cost of reading the
+ * clock, and checked against the result recorded with the stream; a
+ * wrong result is reported and makes the exit status nonzero.
+ *
+ **/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "Flip.h"
+#include "Hashtable.h"
+#include "LinkedList.h"
+#include "Packing.h"
+#include "Zobrist.h"
+
+#define die(msg)    exit (fprintf (stderr, "%s\n", msg))
+#define USAGE "tablebench: tablebench [-n KEYS]"
+// Base 10 integers should be returned from strtol()
+#define BASE 10
+// Default number of distinct keys per stream
+#define KEYS (1L << 18)
+// Kinds of operations; a lookup is recorded with the result it should
+// have
+#define INSERT 0
+#define HIT 1
+#define MISS 2
+#define NKINDS 3
+// Operations are packed as key index << KINDBITS | kind
+#define KINDBITS 2
+// Latencies are counted per nanosecond below MAXNS
+#define MAXNS 8192
+// Slots a growing table starts with
+#define MINSLOTS 1024
+// Slots per bucket of cuckoo, moves tried before it grows, and most
+// times it doubles in a row to find room for every key
+#define CUCKOOWAYS 4
+#define MAXKICKS 500
+#define MAXGROW 8
+// Slots per group of swiss, and the tag of an empty slot
+#define GROUP 16
+#define NOTAG 0x80
+// Home slot (or bucket) of a hash, as Hashtable picks it
+#define HOME(t, h)  ((long) (SLOTMIX(h) >> (64 - (t)->bits)))
+// Tag swiss keeps of a hash: 7 bits that HOME() does not use
+#define TAGOF(h)    ((unsigned char) ((SLOTMIX(h) >> 24) & 0x7F))
+
+/**
+ * Struct: Stream
+ * ~~~~~~~~~~~~~~
+ * A recorded sequence of operations.
+ *
+ * members
+ * ~~~~~~~
+ * char* name:      name in the report
+ * int width:       Words per key
+ * Word* keys:      every key the operations name, width Words each
+ * unsigned long* hash:     hash of each key
+ * long nKeys:      number of keys
+ * long* ops:       the operations, packed
+ * long nOps:       number of operations
+ * long count[]:    number of operations of each kind
+ **/
+typedef struct Stream {
+    char* name;
+    int width;
+    Word* keys;
+    unsigned long* hash;
+    long nKeys;
+    long* ops;
+    long nOps;
+    long count[NKINDS];
+} Stream;
+
+/**
+ * Struct: Strategy
+ * ~~~~~~~~~~~~~~~~
+ * A table under test.  insert() adds a key and returns true (false if
+ * it is there already, or memory ran out); find() returns the value of
+ * a key or MISSING; bytes() returns how much memory the table takes.
+ *
+ * members
+ * ~~~~~~~
+ * char* name:  name in the report
+ **/
+typedef struct Strategy {
+    char* name;
+    void* (*create)(int width, long keys);
+    int (*insert)(void* t, Word* key, unsigned long h, long value);
+    long (*find)(void* t, Word* key, unsigned long h);
+    long (*bytes)(void* t);
+    void (*destroy)(void* t);
+} Strategy;
+
+/**
+ * Struct: Open
+ * ~~~~~~~~~~~~
+ * Flat table of Slots, as in Hashtable, for robinhood and cuckoo (whose
+ * buckets are runs of CUCKOOWAYS slots).
+ *
+ * members
+ * ~~~~~~~
+ * Slot* entry:     the slots (key NULL if empty)
+ * long size:       number of slots (a power of two)
+ * long count:      number of keys
+ * int bits:        log2 of the number of home slots or buckets
+ * int width:       Words per key
+ * unsigned long kick:  state of the choice of slots cuckoo evicts
+ **/
+typedef struct Open {
+    Slot* entry;
+    long size;
+    long count;
+    int bits;
+    int width;
+    unsigned long kick;
+} Open;
+
+/**
+ * Struct: Swiss
+ * ~~~~~~~~~~~~~
+ * Slots in groups of GROUP, with a tag byte per slot: NOTAG if empty,
+ * otherwise TAGOF() the hash of its key.
+ *
+ * members
+ * ~~~~~~~
+ * unsigned char* tag:  tag of each slot
+ * Slot* entry:         the slots
+ * long size:           number of slots (a power of two)
+ * long count:          number of keys
+ * int bits:            log2(size)
+ * int width:           Words per key
+ **/
+typedef struct Swiss {
+    unsigned char* tag;
+    Slot* entry;
+    long size;
+    long count;
+    int bits;
+    int width;
+} Swiss;
+
+/**
+ * Struct: Chained
+ * ~~~~~~~~~~~~~~~
+ * A fixed number of Lists, each a chain of the keys hashed to it.
+ *
+ * members
+ * ~~~~~~~
+ * List* chain:     the chains
+ * long size:       number of chains (a power of two)
+ * int bits:        log2(size)
+ * int width:       Words per key
+ * long bytes:      memory taken, as malloc() hands it out
+ **/
+typedef struct Chained {
+    List* chain;
+    long size;
+    int bits;
+    int width;
+    long bytes;
+} Chained;
+
+void recordBfs(Stream* st, char* name, int height, int width, char* goal,
+        long limit);
+void recordUniform(Stream* st, long keys);
+int replay(Stream* st, Strategy* sg, long overhead);
+long percentile(long* histogram, long total, double p);
+long clockOverhead(void);
+long nanoseconds(void);
+unsigned long nextRandom(unsigned long* state);
+long chunk(long bytes);
+
+static void* createHash(int width, long keys);
+static int insertHash(void* t, Word* key, unsigned long h, long value);
+static long findHash(void* t, Word* key, unsigned long h);
+static long bytesHash(void* t);
+static void destroyHash(void* t);
+static void* createChained(int width, long keys);
+static void* createChainedMtf(int width, long keys);
+static void* makeChained(int width, long keys, int moveToFront);
+static int insertChained(void* t, Word* key, unsigned long h, long value);
+static long findChained(void* t, Word* key, unsigned long h);
+static long bytesChained(void* t);
+static void destroyChained(void* t);
+static void* createRobin(int width, long keys);
+static int insertRobin(void* t, Word* key, unsigned long h, long value);
+static long findRobin(void* t, Word* key, unsigned long h);
+static long bytesOpen(void* t);
+static void destroyOpen(void* t);
+static void* createCuckoo(int width, long keys);
+static int insertCuckoo(void* t, Word* key, unsigned long h, long value);
+static long findCuckoo(void* t, Word* key, unsigned long h);
+static int placeCuckoo(Open* t, Slot* s);
+static int growCuckoo(Open* t, Slot* s);
+static long otherBucket(Open* t, unsigned long h, long b);
+static void* createSwiss(int width, long keys);
+static int insertSwiss(void* t, Word* key, unsigned long h, long value);
+static long findSwiss(void* t, Word* key, unsigned long h);
+static int growSwiss(Swiss* t);
+static unsigned matchGroup(unsigned char* tag, unsigned char want);
+static long bytesSwiss(void* t);
+static void destroySwiss(void* t);
+
+static Strategy strategies[] = {
+    {"hashtable", createHash, insertHash, findHash, bytesHash,
+            destroyHash},
+    {"chained", createChained, insertChained, findChained, bytesChained,
+            destroyChained},
+    {"chained-mtf", createChainedMtf, insertChained, findChained,
+            bytesChained, destroyChained},
+    {"robinhood", createRobin, insertRobin, findRobin, bytesOpen,
+            destroyOpen},
+    {"cuckoo", createCuckoo, insertCuckoo, findCuckoo, bytesOpen,
+            destroyOpen},
+    {"swiss", createSwiss, insertSwiss, findSwiss, bytesSwiss,
+            destroySwiss},
+};
+
+int main(int argc, char* argv[]) {
+    long keys = KEYS;
+    char* endptr;
+    if (argc == 3 && !strcmp(argv[1], "-n")) {
+        keys = strtol(argv[2], &endptr, BASE);
+        if (*endptr != '\0' || keys < 1) {
+            die(USAGE);
+        }
+    } else if (argc != 1) {
+        die(USAGE);
+    }
+    long overhead = clockOverhead();
+    printf("tablebench: %ld keys per stream, %ld ns per clock read "
+            "taken off\n", keys, overhead);
+    int failed = false;
+    for (int k = 0; k < 3; k++) {
+        Stream st;
+        if (k == 0) {
+            recordBfs(&st, "bfs-4x4-distinct", 4, 4, "abcdefghijklmnop",
+                    keys);
+        } else if (k == 1) {
+            recordBfs(&st, "bfs-4x4-binary", 4, 4, "aaaaaaaabbbbbbbb",
+                    keys);
+        } else {
+            recordUniform(&st, keys);
+        }
+        printf("\n%s: %ld keys of %d Word(s), %ld inserts, %ld hits, "
+                "%ld misses\n", st.name, st.nKeys, st.width,
+                st.count[INSERT], st.count[HIT], st.count[MISS]);
+        printf("  %-11s %-18s %-18s %-18s %7s %9s\n", "ns",
+                "insert p50/99/99.9", "hit p50/99/99.9",
+                "miss p50/99/99.9", "mean", "bytes/key");
+        for (int i = 0; i < sizeof(strategies) / sizeof(Strategy); i++) {
+            if (!replay(&st, &strategies[i], overhead)) {
+                fprintf(stderr, "tablebench: %s on %s: FAILED\n",
+                        strategies[i].name, st.name);
+                failed = true;
+            }
+            fflush(stdout);
+        }
+        free(st.keys);
+        free(st.hash);
+        free(st.ops);
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * Function: recordBfs()
+ * ~~~~~~~~~~~~~~~~~~~~~
+ * Records the operations a BFS from GOAL makes on its table until it
+ * has limit configurations, hashed by Zobrist codes as in pancake.
+ *
+ * inputs
+ * ~~~~~~
+ * st: pointer to Stream to fill
+ * name: name of the stream
+ * height, width: dimensions of the pancake
+ * goal: GOAL
+ * limit: most keys recorded
+ *
+ * returns: nothing
+ **/
+void recordBfs(Stream* st, char* name, int height, int width, char* goal,
+        long limit) {
+    Packing pk;
+    Zobrist z;
+    createP(&pk, goal, height * width);
+    int nStep = countMoves(width, height);
+    st->name = name;
+    st->width = pk.width;
+    st->nOps = 0;
+    memset(st->count, 0, sizeof(st->count));
+    // Every neighbor is a hit, or a miss and an insert
+    long room = limit * (nStep + 2);
+    st->keys = malloc(sizeof(Word) * pk.width * limit);
+    st->hash = malloc(sizeof(unsigned long) * limit);
+    st->ops = malloc(sizeof(long) * room);
+    Hashtable seen;
+    if (st->keys == NULL || st->hash == NULL || st->ops == NULL
+            || !createZ(&z, &pk) || !createH(&seen, limit, pk.width, &z)) {
+        die("tablebench: out of memory");
+    }
+    Word batch[(nStep + 1) * pk.width];
+    unsigned long codes[nStep + 1];
+    encodeP(&pk, goal, st->keys);
+    st->hash[0] = keyZ(&z, st->keys);
+    addHashH(seen, st->keys, st->hash[0], 0);
+    st->ops[st->nOps++] = INSERT;
+    st->nKeys = 1;
+    // keys is also the queue of the BFS
+    for (long head = 0; head < st->nKeys && st->nKeys < limit; head++) {
+        Word* config = st->keys + head * pk.width;
+        getBatch(&pk, config, width, height, batch, &z, st->hash[head],
+                codes);
+        for (int j = 0; j < nStep && st->nKeys < limit; j++) {
+            long k = retrieveHashH(seen, batch + j * pk.width, codes[j]);
+            if (k != MISSING) {
+                st->ops[st->nOps++] = (k << KINDBITS) | HIT;
+                continue;
+            }
+            k = st->nKeys++;
+            memcpy(st->keys + k * pk.width, batch + j * pk.width,
+                    sizeof(Word) * pk.width);
+            st->hash[k] = codes[j];
+            addHashH(seen, st->keys + k * pk.width, codes[j], k);
+            st->ops[st->nOps++] = (k << KINDBITS) | MISS;
+            st->ops[st->nOps++] = (k << KINDBITS) | INSERT;
+        }
+    }
+    for (long i = 0; i < st->nOps; i++) {
+        st->count[st->ops[i] & ((1 << KINDBITS) - 1)]++;
+    }
+    destroyH(seen);
+    destroyZ(&z);
+}
+
+/**
+ * Function: recordUniform()
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Makes a stream of random keys of two Words, hashed with hashH(): all
+ * keys are added, then each is looked up, in a random order mixed with
+ * lookups of as many keys that are never added.
+ *
+ * inputs
+ * ~~~~~~
+ * st: pointer to Stream to fill
+ * keys: number of keys added
+ *
+ * returns: nothing
+ **/
+void recordUniform(Stream* st, long keys) {
+    st->name = "uniform";
+    st->width = 2;
+    st->nKeys = 2 * keys;
+    st->nOps = 3 * keys;
+    st->keys = malloc(sizeof(Word) * st->width * st->nKeys);
+    st->hash = malloc(sizeof(unsigned long) * st->nKeys);
+    st->ops = malloc(sizeof(long) * st->nOps);
+    if (st->keys == NULL || st->hash == NULL || st->ops == NULL) {
+        die("tablebench: out of memory");
+    }
+    unsigned long state = 223;
+    for (long k = 0; k < st->nKeys; k++) {
+        for (int j = 0; j < st->width; j++) {
+            st->keys[k * st->width + j] = nextRandom(&state);
+        }
+        st->hash[k] = hashH(st->keys + k * st->width, st->width);
+    }
+    // Keys 0 ... keys-1 are added, and keys ... 2*keys-1 never are
+    for (long k = 0; k < keys; k++) {
+        st->ops[k] = (k << KINDBITS) | INSERT;
+    }
+    for (long k = 0; k < st->nKeys; k++) {
+        st->ops[keys + k] = (k << KINDBITS) | ((k < keys) ? HIT : MISS);
+    }
+    for (long i = st->nOps - 1; i > keys; i--) {
+        long j = keys + nextRandom(&state) % (i - keys + 1);
+        long swap = st->ops[i];
+        st->ops[i] = st->ops[j];
+        st->ops[j] = swap;
+    }
+    st->count[INSERT] = st->count[HIT] = st->count[MISS] = keys;
+}
+
+/**
+ * Function: replay()
+ * ~~~~~~~~~~~~~~~~~~
+ * Runs a stream through a fresh table of one strategy, timing and
+ * checking every operation, and prints a line of the report.
+ *
+ * inputs
+ * ~~~~~~
+ * st: pointer to Stream
+ * sg: pointer to Strategy
+ * overhead: nanoseconds taken off every timing
+ *
+ * returns: true if every operation had the result recorded
+ **/
+int replay(Stream* st, Strategy* sg, long overhead) {
+    long* histogram = calloc(NKINDS * (MAXNS + 1), sizeof(long));
+    void* t = sg->create(st->width, st->count[INSERT]);
+    if (histogram == NULL || t == NULL) {
+        die("tablebench: out of memory");
+    }
+    int ok = true;
+    double total = 0;
+    for (long i = 0; i < st->nOps; i++) {
+        int kind = st->ops[i] & ((1 << KINDBITS) - 1);
+        long k = st->ops[i] >> KINDBITS;
+        Word* key = st->keys + k * st->width;
+        unsigned long h = st->hash[k];
+        long result;
+        long t0 = nanoseconds();
+        if (kind == INSERT) {
+            result = sg->insert(t, key, h, k);
+        } else {
+            result = sg->find(t, key, h);
+        }
+        long ns = nanoseconds() - t0 - overhead;
+        ns = (ns < 0) ? 0 : ns;
+        total += ns;
+        histogram[kind * (MAXNS + 1) + ((ns < MAXNS) ? ns : MAXNS)]++;
+        ok = ok && result == ((kind == INSERT) ? true
+                : (kind == HIT) ? k : MISSING);
+    }
+    printf("  %-11s", sg->name);
+    for (int kind = 0; kind < NKINDS; kind++) {
+        long* h = histogram + kind * (MAXNS + 1);
+        char cell[32];
+        snprintf(cell, sizeof(cell), "%ld/%ld/%ld",
+                percentile(h, st->count[kind], 0.5),
+                percentile(h, st->count[kind], 0.99),
+                percentile(h, st->count[kind], 0.999));
+        printf(" %-18s", cell);
+    }
+    printf(" %7.1f %9.1f\n", total / st->nOps,
+            (double) sg->bytes(t) / st->count[INSERT]);
+    sg->destroy(t);
+    free(histogram);
+    return ok;
+}
+
+/**
+ * Function: percentile()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * Reads a percentile off a histogram of latencies.
+ *
+ * inputs
+ * ~~~~~~
+ * histogram: number of operations that took each number of
+ *            nanoseconds, MAXNS standing for MAXNS or more
+ * total: number of operations
+ * p: fraction of them that should be at most the result
+ *
+ * returns: the percentile in nanoseconds
+ **/
+long percentile(long* histogram, long total, double p) {
+    long below = 0;
+    for (long ns = 0; ns < MAXNS; ns++) {
+        below += histogram[ns];
+        if (below >= p * total) {
+            return ns;
+        }
+    }
+    return MAXNS;
+}
+
+/**
+ * Function: clockOverhead()
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Measures what reading the clock twice costs, as the median of many
+ * tries.
+ *
+ * returns: nanoseconds
+ **/
+long clockOverhead(void) {
+    long histogram[MAXNS + 1] = {0};
+    int tries = 100000;
+    for (int i = 0; i < tries; i++) {
+        long t0 = nanoseconds();
+        long ns = nanoseconds() - t0;
+        histogram[(ns < MAXNS) ? ns : MAXNS]++;
+    }
+    return percentile(histogram, tries, 0.5);
+}
+
+/**
+ * Function: nanoseconds()
+ * ~~~~~~~~~~~~~~~~~~~~~~~
+ * Reads a monotonic clock.
+ *
+ * returns: time in nanoseconds since an arbitrary starting point
+ **/
+long nanoseconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+/**
+ * Function: nextRandom()
+ * ~~~~~~~~~~~~~~~~~~~~~~
+ * splitmix64 generator, as in Zobrist.c.
+ *
+ * input
+ * ~~~~~
+ * state: state of the generator
+ *
+ * returns: next number
+ **/
+unsigned long nextRandom(unsigned long* state) {
+    unsigned long x = (*state += 0x9E3779B97F4A7C15UL);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9UL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBUL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Function: chunk()
+ * ~~~~~~~~~~~~~~~~~
+ * Memory glibc's malloc() takes for a request: the request plus a size
+ * word, rounded up to 16 bytes, and at least 32.
+ *
+ * input
+ * ~~~~~
+ * bytes: size requested
+ *
+ * returns: bytes taken
+ **/
+long chunk(long bytes) {
+    long taken = (bytes + sizeof(long) + 15) & ~15L;
+    return (taken < 32) ? 32 : taken;
+}
+
+/**
+ * Strategy: hashtable
+ * ~~~~~~~~~~~~~~~~~~~
+ * Hashtable, through addHashH() and retrieveHashH(), starting as small
+ * as pancake's.
+ **/
+static void* createHash(int width, long keys) {
+    Hashtable* dict = malloc(sizeof(Hashtable));
+    if (dict == NULL || !createH(dict, MINSLOTS, width, NULL)) {
+        free(dict);
+        return NULL;
+    }
+    return dict;
+}
+
+static int insertHash(void* t, Word* key, unsigned long h, long value) {
+    return addHashH(*(Hashtable*) t, key, h, value) > 0;
+}
+
+static long findHash(void* t, Word* key, unsigned long h) {
+    return retrieveHashH(*(Hashtable*) t, key, h);
+}
+
+static long bytesHash(void* t) {
+    return ((Hashtable*) t)->table->size * sizeof(Slot);
+}
+
+static void destroyHash(void* t) {
+    destroyH(*(Hashtable*) t);
+    free(t);
+}
+
+/**
+ * Strategy: chained
+ * ~~~~~~~~~~~~~~~~~
+ * One List per chain, as many as keys will be added and never resized,
+ * as pancake's first table was; chains are picked by HOME() like the
+ * slots of the others.  Each key takes a Node and a Triple (its value
+ * kept in len).  chained-mtf makes its Lists with moveToFront.
+ **/
+static void* createChained(int width, long keys) {
+    return makeChained(width, keys, false);
+}
+
+static void* createChainedMtf(int width, long keys) {
+    return makeChained(width, keys, true);
+}
+
+static void* makeChained(int width, long keys, int moveToFront) {
+    Chained* t = malloc(sizeof(Chained));
+    if (t == NULL) {
+        return NULL;
+    }
+    t->bits = 1;
+    while ((1L << t->bits) < keys) {
+        t->bits++;
+    }
+    t->size = 1L << t->bits;
+    t->width = width;
+    t->chain = malloc(sizeof(List) * t->size);
+    if (t->chain == NULL) {
+        free(t);
+        return NULL;
+    }
+    for (long i = 0; i < t->size; i++) {
+        if (!createL(&t->chain[i], moveToFront)) {
+            return NULL;
+        }
+    }
+    t->bytes = chunk(sizeof(List) * t->size)
+            + t->size * chunk(sizeof(Node));
+    return t;
+}
+
+static int insertChained(void* p, Word* key, unsigned long h, long value) {
+    Chained* t = p;
+    List chain = t->chain[HOME(t, h)];
+    if (retrieveL(chain, key, h, t->width) != NULL) {
+        return false;
+    }
+    Triple* triple = malloc(sizeof(Triple));
+    if (triple == NULL) {
+        return false;
+    }
+    triple->config = key;
+    triple->prev = NULL;
+    triple->len = value;
+    triple->fromGoal = 0;
+    triple->hash = h;
+    if (!addL(chain, triple)) {
+        free(triple);
+        return false;
+    }
+    t->bytes += chunk(sizeof(Triple)) + chunk(sizeof(Node));
+    return true;
+}
+
+static long findChained(void* p, Word* key, unsigned long h) {
+    Chained* t = p;
+    Triple* triple = retrieveL(t->chain[HOME(t, h)], key, h, t->width);
+    return (triple != NULL) ? triple->len : MISSING;
+}
+
+static long bytesChained(void* t) {
+    return ((Chained*) t)->bytes;
+}
+
+static void destroyChained(void* p) {
+    Chained* t = p;
+    for (long i = 0; i < t->size; i++) {
+        destroyL(t->chain[i]);
+    }
+    free(t->chain);
+    free(t);
+}
+
+/**
+ * Strategy: robinhood
+ * ~~~~~~~~~~~~~~~~~~~
+ * Linear probing from the same home slot as Hashtable, keeping every
+ * run of slots sorted by distance from home: a key being inserted takes
+ * the slot of the first key that is closer to its own home, which then
+ * moves on instead.  A lookup stops as soon as it passes a key closer
+ * to home than it is.  Grows at 3/4 full.
+ **/
+static void* createRobin(int width, long keys) {
+    Open* t = malloc(sizeof(Open));
+    if (t == NULL) {
+        return NULL;
+    }
+    t->bits = 0;
+    while ((1L << t->bits) < MINSLOTS) {
+        t->bits++;
+    }
+    t->size = 1L << t->bits;
+    t->count = 0;
+    t->width = width;
+    t->kick = 0;
+    t->entry = calloc(t->size, sizeof(Slot));
+    if (t->entry == NULL) {
+        free(t);
+        return NULL;
+    }
+    return t;
+}
+
+static int insertRobin(void* p, Word* key, unsigned long h, long value) {
+    Open* t = p;
+    if ((t->count + 1) * 4 > t->size * 3) {
+        Open bigger = *t;
+        bigger.bits++;
+        bigger.size *= 2;
+        bigger.count = 0;
+        bigger.entry = calloc(bigger.size, sizeof(Slot));
+        if (bigger.entry == NULL) {
+            return false;
+        }
+        for (long i = 0; i < t->size; i++) {
+            Slot* e = &t->entry[i];
+            if (e->key != NULL) {
+                insertRobin(&bigger, e->key, e->hash, e->value);
+            }
+        }
+        free(t->entry);
+        *t = bigger;
+    }
+    long mask = t->size - 1;
+    Slot cur = {h, key, value};
+    long i = HOME(t, h);
+    long dist = 0;
+    // Once cur has been swapped, it holds a key that was in the table
+    int displaced = false;
+    for (;;) {
+        Slot* e = &t->entry[i];
+        if (e->key == NULL) {
+            *e = cur;
+            t->count++;
+            return true;
+        }
+        if (!displaced && e->hash == h && sameP(e->key, key, t->width)) {
+            return false;
+        }
+        long d = (i - HOME(t, e->hash)) & mask;
+        if (d < dist) {
+            Slot swap = *e;
+            *e = cur;
+            cur = swap;
+            dist = d;
+            displaced = true;
+        }
+        i = (i + 1) & mask;
+        dist++;
+    }
+}
+
+static long findRobin(void* p, Word* key, unsigned long h) {
+    Open* t = p;
+    long mask = t->size - 1;
+    long i = HOME(t, h);
+    for (long dist = 0; ; dist++) {
+        Slot* e = &t->entry[i];
+        if (e->key == NULL || ((i - HOME(t, e->hash)) & mask) < dist) {
+            return MISSING;
+        }
+        if (e->hash == h && sameP(e->key, key, t->width)) {
+            return e->value;
+        }
+        i = (i + 1) & mask;
+    }
+}
+
+static long bytesOpen(void* t) {
+    return ((Open*) t)->size * sizeof(Slot);
+}
+
+static void destroyOpen(void* t) {
+    free(((Open*) t)->entry);
+    free(t);
+}
+
+/**
+ * Strategy: cuckoo
+ * ~~~~~~~~~~~~~~~~
+ * Every key is in one of two buckets of CUCKOOWAYS slots, picked by two
+ * different mixes of its hash, so a lookup reads at most two buckets.
+ * A key whose buckets are both full takes a slot in one of them, and
+ * the key it evicts moves to its other bucket, and so on for up to
+ * MAXKICKS moves, after which the table doubles.
+ **/
+static void* createCuckoo(int width, long keys) {
+    Open* t = createRobin(width, keys);
+    // bits counts buckets instead of slots
+    if (t != NULL) {
+        t->bits -= 2;
+    }
+    return t;
+}
+
+static int insertCuckoo(void* p, Word* key, unsigned long h, long value) {
+    Open* t = p;
+    if (findCuckoo(t, key, h) != MISSING) {
+        return false;
+    }
+    Slot s = {h, key, value};
+    if (!placeCuckoo(t, &s) && !growCuckoo(t, &s)) {
+        return false;
+    }
+    t->count++;
+    return true;
+}
+
+static long findCuckoo(void* p, Word* key, unsigned long h) {
+    Open* t = p;
+    long b = HOME(t, h);
+    for (int side = 0; side < 2; side++) {
+        Slot* e = t->entry + b * CUCKOOWAYS;
+        for (int k = 0; k < CUCKOOWAYS; k++) {
+            if (e[k].key != NULL && e[k].hash == h
+                    && sameP(e[k].key, key, t->width)) {
+                return e[k].value;
+            }
+        }
+        b = otherBucket(t, h, b);
+    }
+    return MISSING;
+}
+
+/**
+ * Places s in one of its buckets, evicting keys as needed.  On failure
+ * s holds the key left without a slot, which need not be the one that
+ * was passed.
+ **/
+static int placeCuckoo(Open* t, Slot* s) {
+    long b = HOME(t, s->hash);
+    for (int kick = 0; kick <= MAXKICKS; kick++) {
+        // A new key may go in either bucket, an evicted one only in its
+        // other one
+        for (int side = 0; side < ((kick == 0) ? 2 : 1); side++) {
+            Slot* e = t->entry + b * CUCKOOWAYS;
+            for (int k = 0; k < CUCKOOWAYS; k++) {
+                if (e[k].key == NULL) {
+                    e[k] = *s;
+                    return true;
+                }
+            }
+            if (kick == 0 && side == 0) {
+                b = otherBucket(t, s->hash, b);
+            }
+        }
+        Slot* victim = t->entry + b * CUCKOOWAYS
+                + nextRandom(&t->kick) % CUCKOOWAYS;
+        Slot swap = *victim;
+        *victim = *s;
+        *s = swap;
+        b = otherBucket(t, s->hash, b);
+    }
+    return false;
+}
+
+/**
+ * Doubles the table, placing every key again along with s, and
+ * quadruples it and so on if that is not enough.
+ **/
+static int growCuckoo(Open* t, Slot* s) {
+    Slot extra = *s;
+    for (int grow = 1; grow <= MAXGROW; grow++) {
+        Open bigger = *t;
+        bigger.bits += grow;
+        bigger.size <<= grow;
+        bigger.entry = calloc(bigger.size, sizeof(Slot));
+        if (bigger.entry == NULL) {
+            return false;
+        }
+        *s = extra;
+        int ok = placeCuckoo(&bigger, s);
+        for (long i = 0; ok && i < t->size; i++) {
+            if (t->entry[i].key != NULL) {
+                *s = t->entry[i];
+                ok = placeCuckoo(&bigger, s);
+            }
+        }
+        if (ok) {
+            free(t->entry);
+            *t = bigger;
+            return true;
+        }
+        free(bigger.entry);
+    }
+    return false;
+}
+
+/**
+ * The bucket of a key that is not b, b being one of its two.
+ **/
+static long otherBucket(Open* t, unsigned long h, long b) {
+    unsigned long mixed = (h ^ (h >> 31)) * 0xBF58476D1CE4E5B9UL;
+    long home = HOME(t, h);
+    long other = (long) (mixed >> (64 - t->bits));
+    if (other == home) {
+        other = home ^ 1;
+    }
+    return (b == home) ? other : home;
+}
+
+/**
+ * Strategy: swiss
+ * ~~~~~~~~~~~~~~~
+ * Probes whole groups of GROUP slots, starting at the group holding
+ * Hashtable's home slot and moving on by 1, 2, 3 ... groups.  The tags
+ * of a group are compared with TAGOF() the hash at once, and only
+ * slots whose tag matches have their keys compared; a group with an
+ * empty slot ends a lookup.  Nothing is ever removed, so an insertion
+ * takes the first empty slot it finds.  Grows at 7/8 full.
+ **/
+static void* createSwiss(int width, long keys) {
+    Swiss* t = malloc(sizeof(Swiss));
+    if (t == NULL) {
+        return NULL;
+    }
+    t->bits = 0;
+    while ((1L << t->bits) < MINSLOTS) {
+        t->bits++;
+    }
+    t->size = 1L << t->bits;
+    t->count = 0;
+    t->width = width;
+    t->tag = malloc(t->size);
+    t->entry = malloc(sizeof(Slot) * t->size);
+    if (t->tag == NULL || t->entry == NULL) {
+        destroySwiss(t);
+        return NULL;
+    }
+    memset(t->tag, NOTAG, t->size);
+    return t;
+}
+
+static int insertSwiss(void* p, Word* key, unsigned long h, long value) {
+    Swiss* t = p;
+    if ((t->count + 1) * 8 > t->size * 7 && !growSwiss(t)) {
+        return false;
+    }
+    long mask = t->size - 1;
+    unsigned char want = TAGOF(h);
+    long g = HOME(t, h) & ~(long) (GROUP - 1);
+    for (long step = GROUP; ; step += GROUP) {
+        unsigned match = matchGroup(t->tag + g, want);
+        while (match != 0) {
+            Slot* e = &t->entry[g + __builtin_ctz(match)];
+            if (e->hash == h && sameP(e->key, key, t->width)) {
+                return false;
+            }
+            match &= match - 1;
+        }
+        unsigned empty = matchGroup(t->tag + g, NOTAG);
+        if (empty != 0) {
+            long i = g + __builtin_ctz(empty);
+            t->tag[i] = want;
+            t->entry[i].hash = h;
+            t->entry[i].key = key;
+            t->entry[i].value = value;
+            t->count++;
+            return true;
+        }
+        g = (g + step) & mask;
+    }
+}
+
+static long findSwiss(void* p, Word* key, unsigned long h) {
+    Swiss* t = p;
+    long mask = t->size - 1;
+    unsigned char want = TAGOF(h);
+    long g = HOME(t, h) & ~(long) (GROUP - 1);
+    for (long step = GROUP; ; step += GROUP) {
+        unsigned match = matchGroup(t->tag + g, want);
+        while (match != 0) {
+            Slot* e = &t->entry[g + __builtin_ctz(match)];
+            if (e->hash == h && sameP(e->key, key, t->width)) {
+                return e->value;
+            }
+            match &= match - 1;
+        }
+        if (matchGroup(t->tag + g, NOTAG) != 0) {
+            return MISSING;
+        }
+        g = (g + step) & mask;
+    }
+}
+
+static int growSwiss(Swiss* t) {
+    Swiss bigger = *t;
+    bigger.bits++;
+    bigger.size *= 2;
+    bigger.count = 0;
+    bigger.tag = malloc(bigger.size);
+    bigger.entry = malloc(sizeof(Slot) * bigger.size);
+    if (bigger.tag == NULL || bigger.entry == NULL) {
+        free(bigger.tag);
+        free(bigger.entry);
+        return false;
+    }
+    memset(bigger.tag, NOTAG, bigger.size);
+    for (long i = 0; i < t->size; i++) {
+        if (t->tag[i] != NOTAG) {
+            insertSwiss(&bigger, t->entry[i].key, t->entry[i].hash,
+                    t->entry[i].value);
+        }
+    }
+    free(t->tag);
+    free(t->entry);
+    *t = bigger;
+    return true;
+}
+
+/**
+ * Bit k of the result is set if tag k of the group is want.
+ **/
+static unsigned matchGroup(unsigned char* tag, unsigned char want) {
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128((__m128i*) tag);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(group,
+            _mm_set1_epi8((char) want)));
+#else
+    unsigned match = 0;
+    for (int k = 0; k < GROUP; k++) {
+        match |= (unsigned) (tag[k] == want) << k;
+    }
+    return match;
+#endif
+}
+
+static long bytesSwiss(void* t) {
+    return ((Swiss*) t)->size * (sizeof(Slot) + 1);
+}
+
+static void destroySwiss(void* p) {
+    Swiss* t = p;
+    free(t->tag);
+    free(t->entry);
+    free(t);
+}